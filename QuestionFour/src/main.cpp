@@ -8,12 +8,34 @@
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
 #include <iomanip>
 #include <random>
 #include <ctime>
+#include <memory>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+
+#include "../../common/bank_loader.hpp"
+#include "../../common/bank_snapshot.hpp"
+#include "../../common/cli.hpp"
+#include "../../common/csv_writer.hpp"
+#include "../../common/customer.hpp"
+#include "../../common/dictionary.hpp"
+#include "../../common/external_sort.hpp"
+#include "../../common/generators.hpp"
+#include "../../common/index_sort.hpp"
+#include "../../common/parallel_sort.hpp"
+#include "../../common/perf_counters.hpp"
+#include "../../common/radix_sort.hpp"
+#include "../../common/result_sink.hpp"
+#include "../../common/selection.hpp"
+#include "../../common/sorting.hpp"
+#include "../../common/sweep.hpp"
+#include "../../common/string_sort.hpp"
+#include "../../common/timing.hpp"
 
 using namespace std;
 
@@ -33,6 +55,54 @@ struct Record {
 long long comparisons = 0; ///< Global counter for comparisons.
 long long assignments = 0; ///< Global counter for assignments.
 
+/// Sort keys: compile-time projections onto Record fields.
+using ByAge = sorting::Key<sorting::Field<&Record::age>>;
+using ByName = sorting::Key<sorting::Field<&Record::name>>;
+using ByNameThenAge = sorting::ThenBy<ByName, ByAge>;
+
+/// Counting policy feeding the global counters above.
+const sorting::CountOps ops{&comparisons, &assignments};
+
+/// Warm-up/repetition counts for the latency columns (set from the command line).
+timing::Config timingConfig;
+/// Also write every generated and sorted dataset of option 1 to its own CSV (set with --dumps).
+bool dumpDatasets = false;
+/// Store the sorted rows of every option 1 cell in results.jsonl (set with --payloads).
+bool payloadMode = false;
+/// Sizes, datasets, seed, keys, algorithm and output directory of option 1 (common/sweep.hpp).
+sweep::Config sweepConfig;
+
+/// Option 1 runs quickSortWith these options instead of the original quick sort when set
+/// (--algorithm with a variant name from option 7).
+bool recordQuickWith = false;
+sorting::QuickSortOptions recordQuickOptions;
+
+/// @brief Sorts `data` by `key` with the option 1 algorithm, counting through `p`.
+template <class K, class Policy = sorting::NoCount>
+void sortRecords(vector<Record>& data, const K& key, const Policy& p = Policy()) {
+    if (recordQuickWith) sorting::quickSortWith(data, key, recordQuickOptions, p);
+    else sorting::quickSort(data, key, p);
+}
+
+/**
+ * @struct RecordKey
+ * @brief An option 1 sort key: its --key name, console label and result file stem.
+ */
+struct RecordKey {
+    const char* name;
+    const char* label;
+    const char* file;
+};
+const RecordKey RECORD_KEYS[] = {
+    {"age", "Age", "sort_by_age"}, {"name", "Name", "sort_by_name"}, {"combined", "Combined", "sort_combined"}};
+
+/// @brief The RECORD_KEYS entry called `name`, or nullptr.
+const RecordKey* findRecordKey(const string& name) {
+    for (const RecordKey& k : RECORD_KEYS)
+        if (name == k.name) return &k;
+    return nullptr;
+}
+
 ///< Sample names for data generation.
 const vector<string> NAMES = {
     "Amit", "Priya", "Rahul", "Sneha", "Vikram", "Anita", "Ravi", "Meera",
@@ -44,431 +114,1101 @@ const vector<float> AGES = {
     21.0f, 21.5f, 22.0f, 22.5f, 23.0f, 23.5f, 17.8f, 19.8f
 };
 
+/**
+ * @brief Draws one record: a name and an age from the pools, at indices from `pick`.
+ */
+Record drawRecord(gen::Picker& pick) {
+    Record r;
+    r.name = NAMES[pick(NAMES.size())];
+    r.age = AGES[pick(AGES.size())];
+    return r;
+}
+
 /**
  * @brief Generates a vector of random Record data.
  * @param n The number of records to generate.
  * @param rng The random number generator.
+ * @param shape Input distribution (common/generators.hpp); sorted-like shapes are ordered by `key`.
  * @return A vector of generated records.
  */
-vector<Record> generateData(int n, mt19937& rng) {
-    vector<Record> data(n);
-    for (int i = 0; i < n; i++) {
-        data[i].name = NAMES[rng() % NAMES.size()];
-        data[i].age = AGES[rng() % AGES.size()];
-    }
-    return data;
+template <class K = ByAge>
+vector<Record> generateData(long long n, mt19937& rng, gen::Shape shape = gen::Shape::Uniform, const K& key = K()) {
+    return gen::generate<Record>(shape, n, rng, drawRecord, key);
+}
+
+/**
+ * @brief Writes `records` to `path` as "name,age" lines, age with one decimal.
+ * @param header Start with the "name,age" header line.
+ * @return false if the file could not be opened or written.
+ */
+bool writeRecords(const string& path, const vector<Record>& records, bool header) {
+    csv::Writer out(path, 64 << 10);
+    if (header) out.put("name,age\n");
+    for (const Record& r : records)
+        out.put(r.name).put(',').fixed(r.age, 1).put('\n');
+    return out.finish();
+}
+
+/**
+ * @brief Closes `out`, which was writing `path`, and checks that every line got there.
+ * @return false (after printing an error) if the file did not open or a write failed.
+ */
+bool closeOutput(ofstream& out, const string& path) {
+    out.close();
+    if (out) return true;
+    cout << "\nError: Could not write " << path << "\n";
+    return false;
 }
 
-// Custom swap function to count assignments
-void swapRecords(Record& a, Record& b) {
-    Record temp = a;
-    a = b;
-    b = temp;
-    assignments += 3;
+/**
+ * @struct CellResult
+ * @brief What one (key, n, dataset) cell of option 1 measured.
+ */
+struct CellResult {
+    long long comparisons = 0;
+    long long assignments = 0;
+    vector<double> times;  ///< Latency samples (ns) of the uncounted sorts.
+    vector<Record> sorted; ///< The sorted rows, kept only with --payloads.
+    string unwritten;      ///< A --dumps file of this cell that could not be written.
+};
+
+/**
+ * @brief Appends one (key, n, dataset) cell of option 1 to the results file.
+ * @details Holds the base seed, the counters, the median of the cell's latency samples,
+ * the samples themselves (for regression_gate) and, with --payloads, the sorted rows.
+ */
+void saveCell(results::Sink& sink, const char* key, long long n, int dataset, const CellResult& cell) {
+    sink.begin({sweepConfig.algorithm, key, n, dataset, gen::name(sweepConfig.shape)})
+        .field("seed", sweepConfig.seed)
+        .field("comparisons", cell.comparisons)
+        .field("assignments", cell.assignments)
+        .field("median_ns", timing::summarize(cell.times).median)
+        .field("samples_ns", cell.times)
+        .payload(cell.sorted, [](results::Sink::Tuple& row, const Record& r) { row.value(r.name).value(r.age, 1); });
+    sink.end();
 }
 
 /**
- * @brief Partitions the array for Quick Sort by Age.
+ * @brief Runs performance analysis for Quick Sort on Name-Age records.
+ * @details For every size and dataset of the sweep (by default n = 10, 20, ..., 100 with
+ * 10 datasets each), generates records and sorts them by each selected key: the uncounted
+ * latency samples first, then one counted sort for comparisons and assignments. Each
+ * (key, n, dataset) cell generates its records from its own seed (sweep::cellRng) and the
+ * cells run on --threads threads; results are written in cell order, so every file except
+ * the latency columns is the same for any thread count. Per-key CSVs, summary.csv and
+ * results.jsonl go to the --out directory; --dumps datasets go to sweep::Config::dataDir().
  */
-int partitionByAge(vector<Record>& data, int low, int high) {
-    float pivot = data[high].age; // pivot
-    int i = (low - 1); // Index of smaller element
-
-    for (int j = low; j <= high - 1; j++) {
-        comparisons++;
-        if (data[j].age <= pivot) {
-            i++;
-            swapRecords(data[i], data[j]);
+bool nameAgePerformanceAnalysis() {
+    const sweep::Config& cfg = sweepConfig;
+    const string dir = cfg.outDir + "/";
+    const string dataDir = cfg.dataDir() + "/";
+    error_code ec;
+    filesystem::create_directories(cfg.outDir, ec);
+    if (dumpDatasets) filesystem::create_directories(cfg.dataDir(), ec);
+
+    // Per-key result files and the running totals of the current size
+    struct KeyRun {
+        const RecordKey* key;
+        ofstream comps, assigns;
+        long long totalComp = 0, totalAssign = 0;
+        vector<double> times;
+    };
+    vector<KeyRun> runs(cfg.keys.size());
+    for (size_t i = 0; i < runs.size(); i++) {
+        KeyRun& run = runs[i];
+        run.key = findRecordKey(cfg.keys[i]);
+        run.comps.open(dir + run.key->file + ".csv");
+        run.assigns.open(dir + run.key->file + "_assignments.csv");
+        run.comps << "n,dataset,comparisons\n";
+        run.assigns << "n,dataset,assignments\n";
+    }
+    ofstream fSummary(dir + "summary.csv");
+    results::Sink sink(dir + "results.jsonl", payloadMode);
+
+    fSummary << "n";
+    for (const KeyRun& run : runs) fSummary << ",avg_" << run.key->name << "_comp";
+    for (const KeyRun& run : runs) fSummary << ",avg_" << run.key->name << "_assign";
+    for (const KeyRun& run : runs) fSummary << "," << timing::header(run.key->name);
+    fSummary << "\n";
+
+    // Cells are numbered size-major, then dataset, then key (the order of a serial loop)
+    const vector<long long> sizes = cfg.sizes.values();
+    const size_t keys = runs.size();
+    const size_t perSize = keys * cfg.datasets;
+    auto sizeOf = [&](size_t cell) { return sizes[cell / perSize]; };
+    auto datasetOf = [&](size_t cell) { return (int)(cell % perSize / keys) + 1; };
+
+    // Latency samples, then the counted sort, of one dataset by one key
+    auto measure = [&](auto key, const vector<Record>& original, const RecordKey& recordKey, long long n, int d) {
+        CellResult result;
+        timing::sample(original, [&key](vector<Record>& v) { sortRecords(v, key); }, timingConfig, result.times);
+
+        vector<Record> data = original;
+        sortRecords(data, key, sorting::CountOps{&result.comparisons, &result.assignments});
+        if (dumpDatasets) {
+            string path = dir + "sorted" + (recordKey.file + 4) + "_n" + to_string(n) + "_d" + to_string(d) + ".csv";
+            if (!writeRecords(path, data, true)) result.unwritten = path;
+        }
+        if (payloadMode) result.sorted = move(data);
+        return result;
+    };
+
+    // Runs on a pool thread: touches nothing shared but its own dump files
+    auto runCell = [&](size_t cell) {
+        const long long n = sizeOf(cell);
+        const int d = datasetOf(cell);
+        const RecordKey& key = *runs[cell % keys].key;
+        mt19937 rng = sweep::cellRng(cfg.seed, n, d);
+
+        // Sorted-like shapes are ordered by the key this cell sorts by
+        auto generateAndMeasure = [&](auto sortKey) {
+            vector<Record> original = generateData(n, rng, cfg.shape, sortKey);
+            string unwritten;
+            if (dumpDatasets && cell % keys == 0) {
+                string path = dataDir + "dataset_n" + to_string(n) + "_d" + to_string(d) + ".csv";
+                if (!writeRecords(path, original, false)) unwritten = path;
+            }
+            CellResult result = measure(sortKey, original, key, n, d);
+            if (!unwritten.empty()) result.unwritten = unwritten;
+            return result;
+        };
+        if (&key == &RECORD_KEYS[0]) return generateAndMeasure(ByAge());
+        if (&key == &RECORD_KEYS[1]) return generateAndMeasure(ByName());
+        return generateAndMeasure(ByNameThenAge());
+    };
+
+    // Runs on this thread, in cell order
+    size_t unwritten = 0;
+    string firstUnwritten;
+    auto emit = [&](size_t cell, CellResult result) {
+        const long long n = sizeOf(cell);
+        const int d = datasetOf(cell);
+        KeyRun& run = runs[cell % keys];
+        if (!result.unwritten.empty() && unwritten++ == 0) firstUnwritten = result.unwritten;
+        if (cell % perSize == 0) cout << "n = " << setw(3) << n << ": " << flush;
+
+        run.comps << n << "," << d << "," << result.comparisons << "\n";
+        run.assigns << n << "," << d << "," << result.assignments << "\n";
+        run.totalComp += result.comparisons;
+        run.totalAssign += result.assignments;
+        run.times.insert(run.times.end(), result.times.begin(), result.times.end());
+        saveCell(sink, run.key->name, n, d, result);
+        if (cell % keys == keys - 1) cout << "." << flush;
+        if (cell % perSize != perSize - 1) return;
+
+        // Last cell of this size
+        fSummary << n << fixed << setprecision(2);
+        for (const KeyRun& r : runs) fSummary << "," << (double)r.totalComp / cfg.datasets;
+        for (const KeyRun& r : runs) fSummary << "," << (double)r.totalAssign / cfg.datasets;
+        for (const KeyRun& r : runs) timing::writeStats(fSummary, timing::summarize(r.times));
+        fSummary << "\n";
+
+        cout << " Avg:";
+        for (size_t i = 0; i < keys; i++)
+            cout << (i ? ", " : " ") << runs[i].key->label << "=" << (double)runs[i].totalComp / cfg.datasets;
+        cout << "\n";
+        for (KeyRun& r : runs) {
+            r.totalComp = r.totalAssign = 0;
+            r.times.clear();
         }
+    };
+
+    cout << "\nQuick Sort Performance Analysis (Name-Age Records)\n";
+    cout << "===================================================\n";
+    cout << "Algorithm: " << cfg.algorithm << ", shape: " << gen::name(cfg.shape) << ", seed: " << cfg.seed
+         << ", threads: " << cfg.threads << "\n\n";
+
+    sweep::runOrdered(cfg.threads, sizes.size() * perSize, runCell, emit);
+
+    if (!sink.finish()) {
+        cout << "\nError: Could not write " << dir << "results.jsonl\n";
+        return false;
+    }
+    for (KeyRun& run : runs)
+        if (!closeOutput(run.comps, dir + run.key->file + ".csv") ||
+            !closeOutput(run.assigns, dir + run.key->file + "_assignments.csv"))
+            return false;
+    if (!closeOutput(fSummary, dir + "summary.csv")) return false;
+    if (unwritten) {
+        cout << "\nError: Could not write " << firstUnwritten << " and " << unwritten - 1 << " other --dumps files\n";
+        return false;
+    }
+    cout << "\nResults saved to " << dir << "\n";
+    cout << sink.cells() << " cells" << (payloadMode ? " with sorted rows" : "") << " saved to " << dir
+         << "results.jsonl\n";
+    if (dumpDatasets) {
+        cout << "Sorted data saved to " << dir << "sorted_*.csv\n";
+        cout << "Datasets saved to " << dataDir << "\n";
     }
-    swapRecords(data[i + 1], data[high]);
-    return (i + 1);
+    return true;
 }
 
+// ============================================================================
+// OPTION 2: Bank Customer Data Sorting by Salary
+// ============================================================================
+
+/// Bank customers use the compact typed record from common/customer.hpp.
+using bank::Customer;
+
+/// Sort key for the bank data (sorted uncounted with sorting::NoCount).
+using BySalary = sorting::Key<sorting::Field<&Customer::salary>>;
+
+/// Capture hardware counters around each bank sort (set with --perf).
+bool perfMode = false;
+/// Sort (salary, row) pairs instead of whole records (set with --index).
+bool indexMode = false;
+/// Sort salaries with the LSD radix sort instead (set with --radix).
+bool radixMode = false;
+/// Pivot rule, partition, depth limit and insertion cutoff of the serial bank quick
+/// sort (set with --pivot and --cutoff).
+sorting::QuickSortOptions bankQuickOptions;
+/// Load the bank CSV from its binary snapshot when up to date (--no-snapshot disables).
+bool useSnapshot = true;
+/// Hand full output buffers of option 2 to a writer thread (set with --async-write).
+bool asyncWrite = false;
+/// Worker threads for CSV parsing and bank sorts (set with --threads).
+unsigned threadCount = 1;
+
 /**
- * @brief Sorts a vector of Records by age using Quick Sort.
+ * @brief Loads bank customer data from a CSV file (or its up-to-date snapshot).
  */
-void quickSortByAge(vector<Record>& data, int low, int high) {
-    if (low < high) {
-        int pi = partitionByAge(data, low, high);
-        quickSortByAge(data, low, pi - 1);
-        quickSortByAge(data, pi + 1, high);
+vector<Customer> loadBankData(string filename) {
+    vector<Customer> data;
+    csv::LoadStats stats;
+
+    bank::LoadSource source = bank::LoadSource::Csv;
+    bool ok = useSnapshot ? bank::loadCached(filename, data, &stats, threadCount, &source)
+                          : bank::loadCsv(filename, data, &stats, threadCount);
+    if (!ok) {
+        cout << "Error: Could not open file " << filename << endl;
+        return data;
     }
+
+    csv::report(cout, stats, source == bank::LoadSource::Snapshot ? "Loaded snapshot of" : "Parsed");
+    return data;
 }
 
 /**
- * @brief Partitions the array for Quick Sort by Name.
+ * @brief Sorts bank rows by salary and writes them, with the header, to `out`.
+ * @details Whole-record mode sorts `customers` in place. Index mode sorts compact
+ * (salary, row) pairs instead and streams the rows through that permutation once
+ * while writing, so no reordered copy of the table is materialised. With --radix
+ * either mode uses the LSD radix sort on the salary bits instead of comparisons.
+ * The serial quick sort uses the variant chosen with --pivot (default: last-element
+ * Lomuto, the original scheme) and the --cutoff insertion sort threshold.
+ * Nothing is written until the sort is done, so `out` times only the output.
+ * @param counters If non-null, hardware counters are captured around the sort.
+ * @param threads Threads for the whole-record comparison sort (1 sorts serially).
+ * @return The counter reading (all NA when `counters` is null).
  */
-int partitionByName(vector<Record>& data, int low, int high) {
-    string pivot = data[high].name;
-    int i = (low - 1);
-
-    for (int j = low; j <= high - 1; j++) {
-        comparisons++;
-        if (data[j].name <= pivot) {
-            i++;
-            swapRecords(data[i], data[j]);
+perf::Sample sortAndWriteBySalary(vector<Customer>& customers, csv::Writer& out, perf::CounterGroup* counters,
+                                  unsigned threads) {
+    perf::Sample sample;
+    auto run = [&](auto sortFn) {
+        if (counters) sample = perf::measure(*counters, sortFn);
+        else sortFn();
+    };
+
+    if (indexMode) {
+        auto order = sorting::makeIndex(customers, sorting::Field<&Customer::salary>());
+        if (radixMode) run([&] { sorting::radixSort(order, sorting::ByKeyed<double>()); });
+        else run([&] { sorting::quickSortWith(order, sorting::ByKeyed<double>(), bankQuickOptions); });
+        out.put(bank::HEADER).put('\n');
+        sorting::forEachInOrder(customers, order, [&](const Customer& c) { bank::writeLine(out, c); });
+    } else {
+        if (radixMode) {
+            run([&] { sorting::radixSort(customers, BySalary()); });
+        } else if (threads > 1) {
+            parallel::ThreadPool pool(threads);
+            run([&] { parallel::parallelQuickSort(customers, BySalary(), pool); });
+        } else {
+            run([&] { sorting::quickSortWith(customers, BySalary(), bankQuickOptions); });
         }
+        out.put(bank::HEADER).put('\n');
+        for (const auto& c : customers)
+            bank::writeLine(out, c);
     }
-    swapRecords(data[i + 1], data[high]);
-    return (i + 1);
+    return sample;
 }
 
 /**
- * @brief Sorts a vector of Records by name using Quick Sort.
+ * @brief Loads bank customer data, sorts it by salary, and saves the result.
  */
-void quickSortByName(vector<Record>& data, int low, int high) {
-    if (low < high) {
-        int pi = partitionByName(data, low, high);
-        quickSortByName(data, low, pi - 1);
-        quickSortByName(data, pi + 1, high);
+bool bankCustomerSorting() {
+    string input = "../bank_dataset.csv";
+    vector<Customer> customers = loadBankData(input);
+
+    if (customers.empty()) {
+        cout << "\nError: Could not load bank customer data from " << input << endl;
+        return false;
+    }
+
+    cout << "\nBank Customer Data Sorting\n";
+    cout << "===========================\n";
+    cout << "Sorting " << customers.size() << " records by Estimated Salary...\n";
+    
+    csv::Writer fout("../results/sorted_bank_dataset.csv", csv::WRITE_BUFFER_BYTES, asyncWrite);
+    if (perfMode) {
+        perf::CounterGroup counters;
+        perf::Sample sample = sortAndWriteBySalary(customers, fout, &counters, threadCount);
+        ofstream fperf("../results/bank_perf.csv");
+        fperf << "algorithm,rows," << perf::header() << "\n";
+        fperf << (radixMode ? "radix_sort" : "quick_sort") << (indexMode ? "_index," : ",") << customers.size() << ",";
+        perf::writeSample(fperf, sample);
+        fperf << "\n";
+        if (!closeOutput(fperf, "../results/bank_perf.csv")) return false;
+        cout << (counters.available() ? "Hardware counters saved to ../results/bank_perf.csv\n"
+                                      : "Hardware counters unavailable; NA written to ../results/bank_perf.csv\n");
+    } else {
+        sortAndWriteBySalary(customers, fout, nullptr, threadCount);
+    }
+    if (!fout.finish()) {
+        cout << "Error: Could not write ../results/sorted_bank_dataset.csv\n";
+        return false;
     }
+
+    csv::report(cout, fout.stats(customers.size()), "Wrote");
+    cout << "Success! Sorted data saved to ../results/sorted_bank_dataset.csv\n";
+    return true;
+}
+
+// ============================================================================
+// OPTION 3: Bank Customer Data Sorting with Sampling
+// ============================================================================
+
+/**
+ * @brief Samples data from the main bank dataset.
+ * @param shape Input distribution (common/generators.hpp); sorted-like shapes are ordered by salary.
+ */
+vector<Customer> sampleBankData(const vector<Customer>& allCustomers, long long n, mt19937& rng,
+                                gen::Shape shape = gen::Shape::Uniform) {
+    if (allCustomers.empty()) return {};
+    auto drawCustomer = [&](gen::Picker& pick) { return allCustomers[pick(allCustomers.size())]; };
+    return gen::generate<Customer>(shape, n, rng, drawCustomer, BySalary());
 }
 
 /**
- * @brief Partitions the array for Quick Sort by Name then Age.
+ * @brief Runs sorting on sampled bank customer data.
+ * @details Sizes, datasets, seed, shape and --threads are option 1's sweep settings; each
+ * (n, dataset) sample is drawn from its own generator (sweep::cellRng).
  */
-int partitionByNameThenAge(vector<Record>& data, int low, int high) {
-    Record pivot = data[high];
-    int i = (low - 1);
-
-    for (int j = low; j <= high - 1; j++) {
-        // Compare logic: Name first, then Age
-        bool smaller = false;
-        comparisons++;
-        if (data[j].name < pivot.name) {
-            smaller = true;
-        } else if (data[j].name > pivot.name) {
-            smaller = false;
-        } else {
-            comparisons++; 
-            if (data[j].age <= pivot.age) {
-                smaller = true;
-            }
-        }
+bool bankCustomerSamplingSorting() {
+    string main_dataset_path = "../bank_dataset.csv";
+    vector<Customer> allCustomers = loadBankData(main_dataset_path);
+
+    if (allCustomers.empty()) {
+        cout << "\nError: Could not load main bank customer data from " << main_dataset_path << endl;
+        return false;
+    }
+
+    const sweep::Config& cfg = sweepConfig;
 
-        if (smaller) {
-            i++;
-            swapRecords(data[i], data[j]);
+    // With --perf, one row of hardware counters per sampled sort
+    ofstream fperf;
+    if (perfMode) {
+        fperf.open("../results/bank_sampled_perf.csv");
+        fperf << "algorithm,shape,n,dataset," << perf::header() << "\n";
+    }
+
+    cout << "\nBank Customer Data Sorting (with Sampling)\n";
+    cout << "===========================================\n";
+    cout << "Shape: " << gen::name(cfg.shape) << ", seed: " << cfg.seed << ", threads: " << cfg.threads << "\n\n";
+
+    // Cells are (n, dataset) pairs in loop order; each samples with its own generator and
+    // returns its counters and the first of its two files that could not be written, if any
+    struct SampleCell {
+        perf::Sample sample;
+        string unwritten;
+    };
+    const vector<long long> sizes = cfg.sizes.values();
+    const size_t datasets = cfg.datasets;
+
+    // Runs on a pool thread: writes only this cell's two files
+    auto runCell = [&](size_t cell) {
+        const long long n = sizes[cell / datasets];
+        const int d = (int)(cell % datasets) + 1;
+        mt19937 rng = sweep::cellRng(cfg.seed, n, d);
+        vector<Customer> sampledData = sampleBankData(allCustomers, n, rng, cfg.shape);
+
+        // Save unsorted sample
+        string unsorted_filename = "../data/bank_sampled_n" + to_string(n) + "_d" + to_string(d) + ".csv";
+        csv::Writer funsorted(unsorted_filename, 64 << 10);
+        funsorted.put(bank::HEADER).put('\n');
+        for (const auto& c : sampledData)
+            bank::writeLine(funsorted, c);
+        if (!funsorted.finish()) return SampleCell{perf::Sample(), unsorted_filename};
+
+        // Sort the sampled data and save the sorted sample; counters are opened on the sorting thread
+        unique_ptr<perf::CounterGroup> counters;
+        if (perfMode) counters.reset(new perf::CounterGroup());
+        string sorted_filename = "../results/sorted_bank_sampled_n" + to_string(n) + "_d" + to_string(d) + ".csv";
+        csv::Writer fsorted(sorted_filename, 64 << 10);
+        perf::Sample sample = sortAndWriteBySalary(sampledData, fsorted, counters.get(), 1);
+        return SampleCell{sample, fsorted.finish() ? string() : sorted_filename};
+    };
+
+    // Runs on this thread, in cell order
+    size_t unwritten = 0;
+    string firstUnwritten;
+    auto emit = [&](size_t cell, const SampleCell& result) {
+        const long long n = sizes[cell / datasets];
+        const int d = (int)(cell % datasets) + 1;
+        const perf::Sample& sample = result.sample;
+        if (!result.unwritten.empty() && unwritten++ == 0) firstUnwritten = result.unwritten;
+        if (d == 1) cout << "n = " << setw(3) << n << ": " << flush;
+        if (perfMode) {
+            fperf << (radixMode ? "radix_sort" : "quick_sort") << (indexMode ? "_index," : ",") << gen::name(cfg.shape) << "," << n << ","
+                  << d << ",";
+            perf::writeSample(fperf, sample);
+            fperf << "\n";
         }
+        cout << "." << flush;
+        if ((size_t)d == datasets) cout << " Done.\n";
+    };
+
+    sweep::runOrdered(cfg.threads, sizes.size() * datasets, runCell, emit);
+
+    if (unwritten) {
+        cout << "\nError: Could not write " << firstUnwritten << "; " << unwritten << " of "
+             << sizes.size() * datasets << " samples failed\n";
+        return false;
     }
-    swapRecords(data[i + 1], data[high]);
-    return (i + 1);
+    if (perfMode && !closeOutput(fperf, "../results/bank_sampled_perf.csv")) return false;
+    cout << "\nSuccess! Sampled, sorted data saved to ../results/ and ../data/ directories.\n";
+    return true;
 }
 
+// ============================================================================
+// OPTION 4: Parallel Quick Sort Scaling
+// ============================================================================
+
 /**
- * @brief Sorts a vector of Records by name then age using Quick Sort.
+ * @brief Times parallel quick sort of one input for each thread count.
+ * @details Each cell is the median of 3 runs after 1 warm-up. Speedup is relative
+ * to the parallel sort on 1 thread. Quick sort is not stable, so `sorted` only checks
+ * that the output is in key order.
+ * @param withSerial Also time the serial Lomuto quick sort. Skip it for keys with
+ * few distinct values: its two-way partition is quadratic on long runs of equal keys.
  */
-void quickSortByNameThenAge(vector<Record>& data, int low, int high) {
-    if (low < high) {
-        int pi = partitionByNameThenAge(data, low, high);
-        quickSortByNameThenAge(data, low, pi - 1);
-        quickSortByNameThenAge(data, pi + 1, high);
+template <class T, class K>
+void scaleQuickSort(ofstream& out, const string& label, const vector<T>& input, const K& key,
+                    bool withSerial, const vector<unsigned>& threadCounts) {
+    timing::Config cfg;
+    cfg.warmup = 1;
+    cfg.repetitions = 3;
+
+    if (withSerial) {
+        vector<double> serial;
+        timing::sample(input, [&](vector<T>& v) { sorting::quickSort(v, key); }, cfg, serial);
+        double serialMs = timing::summarize(serial).median / 1e6;
+        out << label << "," << input.size() << ",serial,1," << serialMs << ",,1\n";
+        cout << "  " << left << setw(16) << label << " serial      " << right << setw(10) << serialMs << " ms\n";
+    }
+
+    double baseMs = 0;
+    for (unsigned t : threadCounts) {
+        parallel::ThreadPool pool(t);
+        vector<double> samples;
+        timing::sample(input, [&](vector<T>& v) { parallel::parallelQuickSort(v, key, pool); }, cfg, samples);
+        double ms = timing::summarize(samples).median / 1e6;
+        if (t == threadCounts.front()) baseMs = ms;
+
+        vector<T> check = input;
+        parallel::parallelQuickSort(check, key, pool);
+        bool sorted = is_sorted(check.begin(), check.end(),
+                                [&](const T& a, const T& b) { return parallel::less(key, a, b); });
+        out << label << "," << input.size() << ",parallel," << t << "," << ms << ","
+            << baseMs / ms << "," << sorted << "\n";
+        cout << "  " << left << setw(16) << label << " " << setw(2) << t << " threads  " << right
+             << setw(10) << ms << " ms  speedup " << baseMs / ms << (sorted ? "" : "  NOT SORTED") << "\n";
     }
 }
 
 /**
- * @brief Runs performance analysis for Quick Sort on Name-Age records.
+ * @brief Reports parallel quick sort speedup against thread count.
+ * @details Sorts the bank data by salary and 1,000,000 generated Name-Age records by
+ * age, name and name-then-age with 1, 2, 4, ... threads (up to --threads or the
+ * hardware thread count) and writes `../results/parallel_speedup.csv`.
  */
-void nameAgePerformanceAnalysis() {
+bool parallelQuickSortScaling() {
+    unsigned maxThreads = max(threadCount, thread::hardware_concurrency());
+    vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    vector<Customer> customers = loadBankData("../bank_dataset.csv");
     mt19937 rng(time(nullptr));
-    
-    const int DATASETS = 10;
-    
-    ofstream fAge("../results/sort_by_age.csv");
-    ofstream fName("../results/sort_by_name.csv");
-    ofstream fCombined("../results/sort_combined.csv");
-    ofstream fAgeAssign("../results/sort_by_age_assignments.csv");
-    ofstream fNameAssign("../results/sort_by_name_assignments.csv");
-    ofstream fCombinedAssign("../results/sort_combined_assignments.csv");
-    ofstream fSummary("../results/summary.csv");
-    
-    fAge << "n,dataset,comparisons\n";
-    fName << "n,dataset,comparisons\n";
-    fCombined << "n,dataset,comparisons\n";
-    fAgeAssign << "n,dataset,assignments\n";
-    fNameAssign << "n,dataset,assignments\n";
-    fCombinedAssign << "n,dataset,assignments\n";
-    fSummary << "n,avg_age_comp,avg_name_comp,avg_combined_comp,avg_age_assign,avg_name_assign,avg_combined_assign\n";
-    
-    cout << "\nQuick Sort Performance Analysis (Name-Age Records)\n";
-    cout << "===================================================\n\n";
-    
-    for (int n = 10; n <= 100; n += 10) {
-        long long totalAge = 0, totalName = 0, totalCombined = 0;
-        long long totalAgeAssign = 0, totalNameAssign = 0, totalCombinedAssign = 0;
-        
-        cout << "n = " << setw(3) << n << ": ";
-        
-        for (int d = 0; d < DATASETS; d++) {
-            vector<Record> original = generateData(n, rng);
-            
-            ofstream fData("../data/dataset_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            for (auto& r : original)
-                fData << r.name << "," << fixed << setprecision(1) << r.age << "\n";
-            
-            // Sort by age
-            vector<Record> data = original;
-            comparisons = 0;
-            assignments = 0;
-            if (data.size() > 0)
-                quickSortByAge(data, 0, data.size() - 1);
-            fAge << n << "," << d+1 << "," << comparisons << "\n";
-            fAgeAssign << n << "," << d+1 << "," << assignments << "\n";
-            totalAge += comparisons;
-            totalAgeAssign += assignments;
-            
-            ofstream fSortedAge("../results/sorted_by_age_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            fSortedAge << "name,age\n";
-            for (auto& r : data)
-                fSortedAge << r.name << "," << fixed << setprecision(1) << r.age << "\n";
-
-            // Sort by name
-            data = original;
-            comparisons = 0;
-            assignments = 0;
-            if (data.size() > 0)
-                quickSortByName(data, 0, data.size() - 1);
-            fName << n << "," << d+1 << "," << comparisons << "\n";
-            fNameAssign << n << "," << d+1 << "," << assignments << "\n";
-            totalName += comparisons;
-            totalNameAssign += assignments;
-            
-            ofstream fSortedName("../results/sorted_by_name_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            fSortedName << "name,age\n";
-            for (auto& r : data)
-                fSortedName << r.name << "," << fixed << setprecision(1) << r.age << "\n";
-
-            // Combined sort
-            data = original;
-            comparisons = 0;
-            assignments = 0;
-            if (data.size() > 0)
-                quickSortByNameThenAge(data, 0, data.size() - 1);
-            fCombined << n << "," << d+1 << "," << comparisons << "\n";
-            fCombinedAssign << n << "," << d+1 << "," << assignments << "\n";
-            totalCombined += comparisons;
-            totalCombinedAssign += assignments;
-            
-            ofstream fSortedCombined("../results/sorted_combined_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            fSortedCombined << "name,age\n";
-            for (auto& r : data)
-                fSortedCombined << r.name << "," << fixed << setprecision(1) << r.age << "\n";
-
-            cout << ".";
-        }
-        
-        double avgAge = (double)totalAge / DATASETS;
-        double avgName = (double)totalName / DATASETS;
-        double avgCombined = (double)totalCombined / DATASETS;
-        double avgAgeAssign = (double)totalAgeAssign / DATASETS;
-        double avgNameAssign = (double)totalNameAssign / DATASETS;
-        double avgCombinedAssign = (double)totalCombinedAssign / DATASETS;
-        
-        fSummary << n << "," << fixed << setprecision(2) 
-                 << avgAge << "," << avgName << "," << avgCombined << ","
-                 << avgAgeAssign << "," << avgNameAssign << "," << avgCombinedAssign << "\n";
-        
-        cout << " Avg: Age=" << avgAge << ", Name=" << avgName 
-             << ", Combined=" << avgCombined << "\n";
-    }
-    
-    cout << "\nResults saved to ../results/\n";
-    cout << "Sorted data saved to ../results/sorted_*.csv\n";
-    cout << "Datasets saved to ../data/\n";
+    vector<Record> records = generateData(1000000, rng);
+
+    ofstream out("../results/parallel_speedup.csv");
+    out << "key,n,variant,threads,median_ms,speedup,sorted\n";
+    out << fixed << setprecision(3);
+    cout << fixed << setprecision(3);
+
+    cout << "\nParallel Quick Sort Scaling\n";
+    cout << "===========================\n";
+    if (!customers.empty())
+        scaleQuickSort(out, "bank_salary", customers, BySalary(), true, threadCounts);
+    scaleQuickSort(out, "record_age", records, ByAge(), false, threadCounts);
+    scaleQuickSort(out, "record_name", records, ByName(), false, threadCounts);
+    scaleQuickSort(out, "record_name_age", records, ByNameThenAge(), false, threadCounts);
+
+    cout.unsetf(ios::fixed);
+    if (!closeOutput(out, "../results/parallel_speedup.csv")) return false;
+    cout << "\nResults saved to ../results/parallel_speedup.csv\n";
+    return true;
 }
 
 // ============================================================================
-// OPTION 2: Bank Customer Data Sorting by Salary
+// OPTION 5: Dictionary-Encoded Counting Sort
 // ============================================================================
 
+/// Orders customers by country name, as the comparison sorts see the CSV text.
+struct CountryName {
+    string_view operator()(const Customer& c) const { return bank::countryName(c.country); }
+};
+/// Orders customers by gender name.
+struct GenderName {
+    string_view operator()(const Customer& c) const { return bank::genderName(c.gender); }
+};
+using ByCountry = sorting::Key<CountryName>;
+using ByGender = sorting::Key<GenderName>;
+
 /**
- * @struct Customer
- * @brief Represents a bank customer with various attributes.
+ * @brief Times comparison sorts against dictionary encoding plus counting sort on one key.
+ * @details Methods: `quick_sort_3way` (parallel quick sort on one thread: median-of-3,
+ * three-way partition), `merge_sort` (single-buffer, stable), `encode` (dictionary
+ * encoding alone), `counting_sort` (one O(n + k) pass over ready codes, including a copy
+ * of the code column) and `encode_counting_sort` (both, end to end). Each cell is the
+ * median of 3 runs after 1 warm-up; `matches` checks the counting sort against the
+ * stable merge sort.
+ * @param encode Returns the row codes and the number of distinct codes k.
  */
-struct Customer {
-    string id, score, country, gender, age, tenure, balance, products, card, active, churn;
-    double salary;
-};
+template <class T, class K, class Encode, class Same>
+void compareCountingSort(ofstream& out, const string& label, const vector<T>& input, const K& key,
+                         Encode encode, Same same) {
+    timing::Config cfg;
+    cfg.warmup = 1;
+    cfg.repetitions = 3;
+    parallel::ThreadPool pool(1);
+
+    vector<T> expected = input;
+    sorting::mergeSortBuffered(expected, key);
+    auto [codes, k] = encode(input);
+    vector<T> check = input;
+    vector<sorting::Code> checkCodes = codes;
+    sorting::countingSort(check, checkCodes, k);
+    bool matches = equal(check.begin(), check.end(), expected.begin(), same);
+
+    auto report = [&](const string& method, auto sortFn) {
+        vector<double> times;
+        timing::sample(input, sortFn, cfg, times);
+        double ms = timing::summarize(times).median / 1e6;
+        out << label << "," << input.size() << "," << k << "," << method << "," << ms << "," << matches << "\n";
+        cout << "  " << left << setw(16) << label << setw(9) << input.size() << setw(22) << method << right
+             << setw(10) << ms << " ms" << (matches ? "" : "  ORDER MISMATCH") << "\n";
+    };
 
-// Custom swap for Customer
-void swapCustomers(Customer& a, Customer& b) {
-    Customer temp = a;
-    a = b;
-    b = temp;
+    report("quick_sort_3way", [&](vector<T>& v) { parallel::parallelQuickSort(v, key, pool); });
+    report("merge_sort", [&](vector<T>& v) { sorting::mergeSortBuffered(v, key); });
+    report("encode", [&](vector<T>& v) { timing::clobber(encode(v).first.data()); });
+    report("counting_sort", [&](vector<T>& v) {
+        vector<sorting::Code> c = codes;
+        sorting::countingSort(v, c, k);
+    });
+    report("encode_counting_sort", [&](vector<T>& v) {
+        auto [c, kk] = encode(v);
+        sorting::countingSort(v, c, kk);
+    });
 }
 
 /**
- * @brief Loads bank customer data from a CSV file.
+ * @brief Compares comparison sorts with dictionary-encoded counting sort.
+ * @details Generated Name-Age records (10,000 to 1,000,000 rows) by name, age and
+ * name-then-age, and the bank data by country and gender; writes
+ * `../results/counting_sort.csv`.
  */
-vector<Customer> loadBankData(string filename) {
-    vector<Customer> data;
-    ifstream file(filename);
-    string line, item;
+bool dictionaryCountingSort() {
+    mt19937 rng(time(nullptr));
+    vector<Customer> customers = loadBankData("../bank_dataset.csv");
 
-    if (!file.is_open()) {
-        cout << "Error: Could not open file " << filename << endl;
-        return data;
+    ofstream out("../results/counting_sort.csv");
+    out << "key,n,distinct,method,median_ms,matches\n";
+    out << fixed << setprecision(3);
+    cout << fixed << setprecision(3);
+
+    cout << "\nDictionary-Encoded Counting Sort\n";
+    cout << "================================\n";
+    auto sameRecord = [](const Record& a, const Record& b) { return a.name == b.name && a.age == b.age; };
+    auto sameCustomer = [](const Customer& a, const Customer& b) { return a.id == b.id; };
+    auto single = [](auto proj) {
+        return [proj](const auto& rows) {
+            auto column = sorting::encodeColumn(rows, proj);
+            return make_pair(move(column.codes), column.dict.size());
+        };
+    };
+    auto nameThenAge = [](const vector<Record>& rows) {
+        auto names = sorting::encodeColumn(rows, sorting::Field<&Record::name>());
+        auto ages = sorting::encodeColumn(rows, sorting::Field<&Record::age>());
+        return make_pair(sorting::combineCodes(names, ages), names.dict.size() * ages.dict.size());
+    };
+
+    for (int n : {10000, 100000, 1000000}) {
+        vector<Record> records = generateData(n, rng);
+        compareCountingSort(out, "record_name", records, ByName(), single(sorting::Field<&Record::name>()), sameRecord);
+        compareCountingSort(out, "record_age", records, ByAge(), single(sorting::Field<&Record::age>()), sameRecord);
+        compareCountingSort(out, "record_name_age", records, ByNameThenAge(), nameThenAge, sameRecord);
+    }
+    if (!customers.empty()) {
+        compareCountingSort(out, "bank_country", customers, ByCountry(), single(CountryName()), sameCustomer);
+        compareCountingSort(out, "bank_gender", customers, ByGender(), single(GenderName()), sameCustomer);
     }
 
-    getline(file, line); // Skip header
-    while (getline(file, line)) {
-        stringstream ss(line);
-        vector<string> row;
-        while (getline(ss, item, ',')) row.push_back(item);
-
-        if (row.size() >= 12) {
-            Customer c;
-            c.id = row[0]; c.score = row[1]; c.country = row[2];
-            c.gender = row[3]; c.age = row[4]; c.tenure = row[5];
-            c.balance = row[6]; c.products = row[7]; c.card = row[8];
-            c.active = row[9];
-            try { c.salary = stod(row[10]); } catch (...) { c.salary = 0.0; }
-            c.churn = row[11];
-            data.push_back(c);
-        }
+    cout.unsetf(ios::fixed);
+    if (!closeOutput(out, "../results/counting_sort.csv")) return false;
+    cout << "\nResults saved to ../results/counting_sort.csv\n";
+    return true;
+}
+
+// ============================================================================
+// OPTION 6: String Sorts (Multikey Quicksort)
+// ============================================================================
+
+///< Syllables for generated high-cardinality surnames.
+const vector<string> SYLLABLES = {
+    "an", "bel", "cor", "dan", "el", "fer", "gar", "hol",
+    "in", "jon", "kar", "lin", "mor", "nor", "pet", "son"
+};
+
+/**
+ * @brief Generates records whose names are 2-4 random syllables (about 70,000 distinct,
+ * with many shared prefixes), ages as in generateData().
+ */
+vector<Record> generateSurnames(int n, mt19937& rng) {
+    vector<Record> data(n);
+    for (int i = 0; i < n; i++) {
+        int parts = 2 + rng() % 3;
+        for (int k = 0; k < parts; k++)
+            data[i].name += SYLLABLES[rng() % SYLLABLES.size()];
+        data[i].age = AGES[rng() % AGES.size()];
     }
     return data;
 }
 
 /**
- * @brief Partition for Bank Customer Data by Salary.
+ * @brief Counts and times the string sorts on one input sorted by name.
+ * @details Comparisons, assignments and character reads come from one counted run,
+ * median_ms from 3 uncounted runs after 1 warm-up; `sorted` checks name order.
+ * @param withQuickSort Also run the Lomuto quick sort (quadratic on few distinct names).
+ */
+void compareStringSorts(ofstream& out, const string& label, const vector<Record>& input, bool withQuickSort) {
+    timing::Config cfg;
+    cfg.warmup = 1;
+    cfg.repetitions = 3;
+
+    auto report = [&](const string& method, auto sortFn) {
+        long long characters = 0;
+        sorting::CountOps counted{&comparisons, &assignments, nullptr, &characters};
+        comparisons = 0;
+        assignments = 0;
+        vector<Record> data = input;
+        sortFn(data, counted);
+        bool sorted = is_sorted(data.begin(), data.end(),
+                                [](const Record& a, const Record& b) { return a.name < b.name; });
+
+        vector<double> times;
+        timing::sample(input, [&](vector<Record>& v) { sortFn(v, sorting::NoCount()); }, cfg, times);
+        double ms = timing::summarize(times).median / 1e6;
+
+        out << label << "," << input.size() << "," << method << "," << comparisons << "," << assignments << ","
+            << characters << "," << ms << "," << sorted << "\n";
+        cout << "  " << left << setw(12) << label << setw(9) << input.size() << setw(20) << method << right
+             << " chars " << setw(12) << characters << "  " << setw(10) << ms << " ms"
+             << (sorted ? "" : "  NOT SORTED") << "\n";
+    };
+
+    if (withQuickSort)
+        report("quick_sort", [](vector<Record>& v, const auto& p) { sorting::quickSort(v, ByName(), p); });
+    report("merge_sort", [](vector<Record>& v, const auto& p) { sorting::mergeSortBuffered(v, ByName(), p); });
+    report("multikey_quicksort", [](vector<Record>& v, const auto& p) { sorting::multikeyQuickSort(v, ByName(), p); });
+}
+
+/**
+ * @brief Compares multikey quicksort with comparison sorts on string keys.
+ * @details High-cardinality generated surnames and the 16 generated names, 1,000 to
+ * 1,000,000 rows; writes `../results/string_sort.csv`.
  */
-int partitionBySalary(vector<Customer>& data, int low, int high) {
-    double pivot = data[high].salary;
-    int i = (low - 1);
-
-    for (int j = low; j <= high - 1; j++) {
-        if (data[j].salary <= pivot) {
-            i++;
-            swapCustomers(data[i], data[j]);
+bool stringSortComparison() {
+    mt19937 rng(time(nullptr));
+
+    ofstream out("../results/string_sort.csv");
+    out << "key,n,method,comparisons,assignments,characters,median_ms,sorted\n";
+    out << fixed << setprecision(3);
+    cout << fixed << setprecision(3);
+
+    cout << "\nString Sorts (character reads)\n";
+    cout << "==============================\n";
+    for (int n : {1000, 10000, 100000, 1000000}) {
+        compareStringSorts(out, "surname", generateSurnames(n, rng), true);
+        compareStringSorts(out, "name", generateData(n, rng), false);
+    }
+
+    cout.unsetf(ios::fixed);
+    if (!closeOutput(out, "../results/string_sort.csv")) return false;
+    cout << "\nResults saved to ../results/string_sort.csv\n";
+    return true;
+}
+
+// ============================================================================
+// OPTION 7: Quick Sort Pivot Policies
+// ============================================================================
+
+/// @brief Named quickSortWith configuration for the pivot benchmark.
+struct QuickVariant {
+    string name;
+    sorting::QuickSortOptions options;
+};
+
+/// @brief Every pivot rule with both partitions, plus the depth-limited variants.
+vector<QuickVariant> quickVariants() {
+    const pair<const char*, sorting::Pivot> pivots[] = {
+        {"last", sorting::Pivot::Last}, {"median3", sorting::Pivot::MedianOf3},
+        {"ninther", sorting::Pivot::Ninther}, {"random", sorting::Pivot::Random}};
+    vector<QuickVariant> variants;
+    for (bool threeWay : {false, true}) {
+        for (const auto& [name, pivot] : pivots) {
+            sorting::QuickSortOptions o;
+            o.pivot = pivot;
+            o.threeWay = threeWay;
+            variants.push_back({string(threeWay ? "3way_" : "lomuto_") + name, o});
         }
     }
-    swapCustomers(data[i + 1], data[high]);
-    return (i + 1);
+    sorting::QuickSortOptions limited;
+    limited.depthLimit = true;
+    variants.push_back({"lomuto_last_introsort", limited});
+    variants.push_back({"introsort", sorting::QuickSortOptions::introsort()});
+    return variants;
 }
 
 /**
- * @brief Sorts a vector of Customers by salary using Quick Sort.
+ * @brief Counts and times every quick sort variant on one input.
+ * @details Comparisons, assignments, the deepest partition level and heapsort
+ * fallbacks come from one counted run; median_ms from 3 uncounted runs after 1 warm-up.
  */
-void quickSortBySalary(vector<Customer>& data, int low, int high) {
-    if (low < high) {
-        int pi = partitionBySalary(data, low, high);
-        quickSortBySalary(data, low, pi - 1);
-        quickSortBySalary(data, pi + 1, high);
+template <class T, class K>
+void comparePivotPolicies(ofstream& out, const string& label, const vector<T>& input, const K& key) {
+    timing::Config cfg;
+    cfg.warmup = 1;
+    cfg.repetitions = 3;
+
+    for (const QuickVariant& variant : quickVariants()) {
+        sorting::QuickSortStats stats;
+        sorting::QuickSortOptions counted = variant.options;
+        counted.stats = &stats;
+        comparisons = 0;
+        assignments = 0;
+        vector<T> data = input;
+        sorting::quickSortWith(data, key, counted, ops);
+        bool sorted = is_sorted(data.begin(), data.end(),
+                                [&](const T& a, const T& b) { return key.compare(a, b, sorting::NoCount()) < 0; });
+
+        vector<double> times;
+        timing::sample(input, [&](vector<T>& v) { sorting::quickSortWith(v, key, variant.options); }, cfg, times);
+        double ms = timing::summarize(times).median / 1e6;
+
+        out << label << "," << input.size() << "," << variant.name << "," << comparisons << "," << assignments
+            << "," << stats.maxDepth << "," << stats.heapSorts << "," << ms << "," << sorted << "\n";
+        cout << "  " << left << setw(14) << label << setw(24) << variant.name << right
+             << " comp " << setw(10) << comparisons << "  depth " << setw(6) << stats.maxDepth
+             << "  " << setw(9) << ms << " ms" << (sorted ? "" : "  NOT SORTED") << "\n";
     }
 }
 
 /**
- * @brief Loads bank customer data, sorts it by salary, and saves the result.
+ * @brief Compares pivot rules, partition schemes and the introsort fallback.
+ * @details Inputs: 10,000 generated Name-Age records by age and by name (16 distinct
+ * values each) and the bank data by salary as loaded, already sorted and reversed;
+ * writes `../results/pivot_policies.csv`.
  */
-void bankCustomerSorting() {
-    string input = "../bank_dataset.csv";
-    vector<Customer> customers = loadBankData(input);
+bool pivotPolicyComparison() {
+    mt19937 rng(time(nullptr));
+    vector<Customer> customers = loadBankData("../bank_dataset.csv");
+    vector<Record> records = generateData(10000, rng);
 
-    if (customers.empty()) {
-        cout << "\nError: Could not load bank customer data from " << input << endl;
-        return;
+    ofstream out("../results/pivot_policies.csv");
+    out << "input,n,variant,comparisons,assignments,max_depth,heap_sorts,median_ms,sorted\n";
+    out << fixed << setprecision(3);
+    cout << fixed << setprecision(3);
+
+    cout << "\nQuick Sort Pivot Policies\n";
+    cout << "=========================\n";
+    comparePivotPolicies(out, "record_age", records, ByAge());
+    comparePivotPolicies(out, "record_name", records, ByName());
+    if (!customers.empty()) {
+        comparePivotPolicies(out, "bank_salary", customers, BySalary());
+        vector<Customer> sorted = customers;
+        sorting::mergeSortBuffered(sorted, BySalary());
+        comparePivotPolicies(out, "bank_sorted", sorted, BySalary());
+        reverse(sorted.begin(), sorted.end());
+        comparePivotPolicies(out, "bank_reversed", sorted, BySalary());
     }
 
-    cout << "\nBank Customer Data Sorting\n";
-    cout << "===========================\n";
-    cout << "Sorting " << customers.size() << " records by Estimated Salary...\n";
-    
-    quickSortBySalary(customers, 0, customers.size() - 1);
+    cout.unsetf(ios::fixed);
+    if (!closeOutput(out, "../results/pivot_policies.csv")) return false;
+    cout << "\nResults saved to ../results/pivot_policies.csv\n";
+    return true;
+}
 
-    ofstream fout("../results/sorted_bank_dataset.csv");
-    fout << "customer_id,credit_score,country,gender,age,tenure,balance,products_number,credit_card,active_member,estimated_salary,churn\n";
-    
-    for (const auto& c : customers) {
-        fout << c.id << "," << c.score << "," << c.country << "," << c.gender << ","
-             << c.age << "," << c.tenure << "," << c.balance << "," << c.products << ","
-             << c.card << "," << c.active << "," << fixed << setprecision(2) << c.salary << ","
-             << c.churn << "\n";
+// ============================================================================
+// OPTION 8: Hybrid Insertion Cutoff Sweep
+// ============================================================================
+
+/// Cutoffs tried by the sweep; 1 means no insertion sort.
+const vector<int> CUTOFFS = {1, 4, 8, 12, 16, 20, 24, 32, 40, 48, 56, 64};
+
+/**
+ * @brief Times `sortFn(v, cutoff)` for every cutoff and records the fastest.
+ * @details Each cell is the median of 5 runs after 1 warm-up. Writes one row per
+ * cutoff to `out` and the best cutoff, against cutoff 1, to `best`.
+ */
+template <class T, class SortFn>
+void sweepCutoff(ofstream& out, ofstream& best, const string& algorithm, const string& label,
+                 const vector<T>& input, SortFn sortFn) {
+    timing::Config cfg;
+    cfg.warmup = 1;
+    cfg.repetitions = 5;
+
+    double baseMs = 0, bestMs = 0;
+    int bestCutoff = 1;
+    for (int cutoff : CUTOFFS) {
+        vector<double> times;
+        timing::sample(input, [&](vector<T>& v) { sortFn(v, cutoff); }, cfg, times);
+        double ms = timing::summarize(times).median / 1e6;
+        if (cutoff == 1) baseMs = bestMs = ms;
+        if (ms < bestMs) {
+            bestMs = ms;
+            bestCutoff = cutoff;
+        }
+        out << algorithm << "," << label << "," << input.size() << "," << cutoff << "," << ms << ","
+            << baseMs / ms << "\n";
     }
+    best << algorithm << "," << label << "," << input.size() << "," << bestCutoff << "," << bestMs << ","
+         << baseMs << "\n";
+    cout << "  " << left << setw(12) << algorithm << setw(13) << label << right << " best cutoff " << setw(2)
+         << bestCutoff << ": " << setw(9) << bestMs << " ms (" << baseMs << " ms without)\n";
+}
 
-    cout << "Success! Sorted data saved to ../results/sorted_bank_dataset.csv\n";
+/**
+ * @brief Sweeps the insertion sort cutoff of the hybrid merge and quick sorts.
+ * @details Float age and string name keys on 100,000 generated records, double salary
+ * on the bank data. The quick sort is the introsort configuration. Writes every cell to
+ * `../results/cutoff_sweep.csv` and the best cutoff per algorithm and key type to
+ * `../results/cutoff_best.csv`.
+ */
+bool cutoffSweep() {
+    mt19937 rng(time(nullptr));
+    vector<Customer> customers = loadBankData("../bank_dataset.csv");
+    vector<Record> records = generateData(100000, rng);
+
+    ofstream out("../results/cutoff_sweep.csv");
+    ofstream best("../results/cutoff_best.csv");
+    out << "algorithm,key,n,cutoff,median_ms,speedup\n";
+    best << "algorithm,key,n,best_cutoff,best_ms,no_cutoff_ms\n";
+    out << fixed << setprecision(3);
+    best << fixed << setprecision(3);
+    cout << fixed << setprecision(3);
+
+    cout << "\nHybrid Insertion Cutoff Sweep\n";
+    cout << "=============================\n";
+    auto merge = [](auto key) {
+        return [key](auto& v, int cutoff) { sorting::mergeSortHybrid(v, key, cutoff); };
+    };
+    auto quick = [](auto key) {
+        return [key](auto& v, int cutoff) {
+            sorting::QuickSortOptions o = sorting::QuickSortOptions::introsort();
+            o.cutoff = cutoff;
+            sorting::quickSortWith(v, key, o);
+        };
+    };
+    sweepCutoff(out, best, "merge_sort", "age_float", records, merge(ByAge()));
+    sweepCutoff(out, best, "merge_sort", "name_string", records, merge(ByName()));
+    if (!customers.empty()) sweepCutoff(out, best, "merge_sort", "salary_double", customers, merge(BySalary()));
+    sweepCutoff(out, best, "quick_sort", "age_float", records, quick(ByAge()));
+    sweepCutoff(out, best, "quick_sort", "name_string", records, quick(ByName()));
+    if (!customers.empty()) sweepCutoff(out, best, "quick_sort", "salary_double", customers, quick(BySalary()));
+
+    cout.unsetf(ios::fixed);
+    if (!closeOutput(out, "../results/cutoff_sweep.csv") || !closeOutput(best, "../results/cutoff_best.csv"))
+        return false;
+    cout << "\nResults saved to ../results/cutoff_sweep.csv and ../results/cutoff_best.csv\n";
+    return true;
 }
 
 // ============================================================================
-// OPTION 3: Bank Customer Data Sorting with Sampling
+// OPTION 9: Selection Engine (top-k, percentiles, median)
 // ============================================================================
 
+/// Percentiles asked for by the quantile query.
+const vector<double> QUANTILES = {0.50, 0.90, 0.95, 0.99};
+/// Size of the top-k query.
+const size_t TOP_K = 100;
+
 /**
- * @brief Samples data from the main bank dataset.
+ * @brief The TOP_K highest salaries of the bank CSV at `path`, streamed row by row.
+ * @details Rows are parsed from double-buffered blocks and pushed into a bounded
+ * heap, so only TOP_K customers are held at any time.
  */
-vector<Customer> sampleBankData(const vector<Customer>& allCustomers, int n, mt19937& rng) {
-    vector<Customer> sampledData;
-    if (allCustomers.empty() || n == 0) {
-        return sampledData;
-    }
-    
-    uniform_int_distribution<size_t> dist(0, allCustomers.size() - 1);
-    
-    for (int i = 0; i < n; ++i) {
-        sampledData.push_back(allCustomers[dist(rng)]);
-    }
-    
-    return sampledData;
+template <class Policy>
+vector<Customer> streamTopSalaries(const string& path, const Policy& p) {
+    sorting::TopK<Customer, BySalary, Policy> top(TOP_K, BySalary(), p);
+    external::BlockReader reader(path, 1 << 20);
+    bool header = true;
+    external::forEachLine(reader, [&](string_view line) {
+        Customer c;
+        if (header) header = false;
+        else if (bank::parseLine(line, c)) top.push(c);
+    });
+    return top.take();
 }
 
 /**
- * @brief Runs sorting on sampled bank customer data.
+ * @brief Answers the median, percentile and top-k salary queries with every method.
+ * @details Each method returns the salaries it found. Comparisons and assignments come
+ * from one counted run, median_ms from 5 uncounted runs after 1 warm-up, and `correct`
+ * checks the answer against a full sort. `csvPath`, if not empty, is the CSV `input`
+ * was loaded from; the top-k query then also streams it.
  */
-void bankCustomerSamplingSorting() {
-    string main_dataset_path = "../bank_dataset.csv";
-    vector<Customer> allCustomers = loadBankData(main_dataset_path);
+void compareSelection(ofstream& out, const string& label, const vector<Customer>& input, const string& csvPath) {
+    timing::Config cfg;
+    cfg.warmup = 1;
+    cfg.repetitions = 5;
+    const size_t n = input.size();
+    const size_t k = min(TOP_K, n);
 
-    if (allCustomers.empty()) {
-        cout << "\nError: Could not load main bank customer data from " << main_dataset_path << endl;
-        return;
-    }
+    vector<double> sorted;
+    for (const Customer& c : input) sorted.push_back(c.salary);
+    sort(sorted.begin(), sorted.end());
+    vector<double> expectedMedian = {sorted[sorting::quantileRank(n, 0.5)]};
+    vector<double> expectedQuantiles;
+    for (double q : QUANTILES) expectedQuantiles.push_back(sorted[sorting::quantileRank(n, q)]);
+    vector<double> expectedTop(sorted.rbegin(), sorted.rbegin() + k);
 
-    mt19937 rng(time(nullptr));
-    const int DATASETS = 10;
+    auto salaries = [](auto first, auto last) {
+        vector<double> s;
+        for (; first != last; ++first) s.push_back(first->salary);
+        return s;
+    };
+    auto report = [&](const string& query, const string& method, const vector<double>& expected, auto fn) {
+        comparisons = 0;
+        assignments = 0;
+        vector<Customer> data = input;
+        bool correct = fn(data, ops) == expected;
 
-    cout << "\nBank Customer Data Sorting (with Sampling)\n";
-    cout << "===========================================\n\n";
-
-    for (int n = 10; n <= 100; n += 10) {
-        cout << "n = " << setw(3) << n << ": ";
-        for (int d = 0; d < DATASETS; d++) {
-            // Sample data
-            vector<Customer> sampledData = sampleBankData(allCustomers, n, rng);
-
-            // Save unsorted sample
-            string unsorted_filename = "../data/bank_sampled_n" + to_string(n) + "_d" + to_string(d+1) + ".csv";
-            ofstream funsorted(unsorted_filename);
-            funsorted << "customer_id,credit_score,country,gender,age,tenure,balance,products_number,credit_card,active_member,estimated_salary,churn\n";
-            for (const auto& c : sampledData) {
-                funsorted << c.id << "," << c.score << "," << c.country << "," << c.gender << ","
-                         << c.age << "," << c.tenure << "," << c.balance << "," << c.products << ","
-                         << c.card << "," << c.active << "," << fixed << setprecision(2) << c.salary << ","
-                         << c.churn << "\n";
-            }
-            funsorted.close();
-
-            // Sort the sampled data
-            quickSortBySalary(sampledData, 0, sampledData.size() - 1);
-
-            // Save sorted sample
-            string sorted_filename = "../results/sorted_bank_sampled_n" + to_string(n) + "_d" + to_string(d+1) + ".csv";
-            ofstream fsorted(sorted_filename);
-            fsorted << "customer_id,credit_score,country,gender,age,tenure,balance,products_number,credit_card,active_member,estimated_salary,churn\n";
-            for (const auto& c : sampledData) {
-                fsorted << c.id << "," << c.score << "," << c.country << "," << c.gender << ","
-                       << c.age << "," << c.tenure << "," << c.balance << "," << c.products << ","
-                       << c.card << "," << c.active << "," << fixed << setprecision(2) << c.salary << ","
-                       << c.churn << "\n";
-            }
-            fsorted.close();
+        vector<double> times;
+        timing::sample(input, [&](vector<Customer>& v) { fn(v, sorting::NoCount()); }, cfg, times);
+        double ms = timing::summarize(times).median / 1e6;
 
-            cout << ".";
-        }
-        cout << " Done.\n";
+        out << label << "," << n << "," << query << "," << method << "," << comparisons << "," << assignments
+            << "," << ms << "," << correct << "\n";
+        cout << "  " << left << setw(11) << label << setw(11) << query << setw(17) << method << right
+             << " comp " << setw(10) << comparisons << "  " << setw(9) << ms << " ms"
+             << (correct ? "" : "  WRONG ANSWER") << "\n";
+    };
+
+    sorting::QuickSortOptions quickselect;
+    quickselect.pivot = sorting::Pivot::Random;
+    const sorting::QuickSortOptions introselect = sorting::QuickSortOptions::introsort();
+    auto fullSort = [&](vector<Customer>& v, const auto& p) { sorting::quickSortWith(v, BySalary(), introselect, p); };
+
+    // Median
+    auto median = [&](const sorting::QuickSortOptions& opt) {
+        return [&, opt](vector<Customer>& v, const auto& p) {
+            return vector<double>{sorting::selectKth(v, sorting::quantileRank(n, 0.5), BySalary(), opt, p).salary};
+        };
+    };
+    report("median", "full_sort", expectedMedian, [&](vector<Customer>& v, const auto& p) {
+        fullSort(v, p);
+        return vector<double>{v[sorting::quantileRank(n, 0.5)].salary};
+    });
+    report("median", "quickselect", expectedMedian, median(quickselect));
+    report("median", "introselect", expectedMedian, median(introselect));
+
+    // Percentiles
+    report("quantiles", "full_sort", expectedQuantiles, [&](vector<Customer>& v, const auto& p) {
+        fullSort(v, p);
+        vector<double> s;
+        for (double q : QUANTILES) s.push_back(v[sorting::quantileRank(n, q)].salary);
+        return s;
+    });
+    report("quantiles", "introselect_each", expectedQuantiles, [&](vector<Customer>& v, const auto& p) {
+        vector<double> s;
+        for (double q : QUANTILES) s.push_back(sorting::selectKth(v, sorting::quantileRank(n, q), BySalary(), introselect, p).salary);
+        return s;
+    });
+    report("quantiles", "multi_select", expectedQuantiles, [&](vector<Customer>& v, const auto& p) {
+        vector<Customer> found = sorting::selectQuantiles(v, QUANTILES, BySalary(), introselect, p);
+        return salaries(found.begin(), found.end());
+    });
+
+    // Top k, highest first
+    const string topQuery = "top" + to_string(TOP_K);
+    report(topQuery, "full_sort", expectedTop, [&](vector<Customer>& v, const auto& p) {
+        fullSort(v, p);
+        return salaries(v.rbegin(), v.rbegin() + k);
+    });
+    report(topQuery, "select_then_sort", expectedTop, [&](vector<Customer>& v, const auto& p) {
+        sorting::selectKth(v, (ptrdiff_t)(n - k), BySalary(), introselect, p);
+        vector<Customer> top(v.end() - k, v.end());
+        sorting::quickSortWith(top, BySalary(), introselect, p);
+        return salaries(top.rbegin(), top.rend());
+    });
+    report(topQuery, "bounded_heap", expectedTop, [&](vector<Customer>& v, const auto& p) {
+        sorting::TopK<Customer, BySalary, decay_t<decltype(p)>> top(TOP_K, BySalary(), p);
+        for (const Customer& c : v) top.push(c);
+        vector<Customer> found = top.take();
+        return salaries(found.begin(), found.end());
+    });
+    if (!csvPath.empty())
+        report(topQuery, "heap_stream_csv", expectedTop, [&](vector<Customer>&, const auto& p) {
+            vector<Customer> found = streamTopSalaries(csvPath, p);
+            return salaries(found.begin(), found.end());
+        });
+
+    cout << "  -> median " << expectedMedian[0] << ", p90 " << expectedQuantiles[1] << ", p99 "
+         << expectedQuantiles[3] << ", highest " << expectedTop[0] << "\n";
+}
+
+/**
+ * @brief Median, percentile and top-k salary queries without (and with) a full sort.
+ * @details Runs on the bank data and on 100 copies of it (1,000,000 rows); the top-k
+ * query on the bank data also streams `../bank_dataset.csv` through a bounded heap
+ * without loading it. Writes `../results/selection.csv`.
+ */
+bool selectionEngine() {
+    const string path = "../bank_dataset.csv";
+    vector<Customer> customers = loadBankData(path);
+    if (customers.empty()) {
+        cout << "\nError: Could not load bank customer data from " << path << endl;
+        return false;
     }
+    vector<Customer> copies;
+    copies.reserve(customers.size() * 100);
+    for (int r = 0; r < 100; r++) copies.insert(copies.end(), customers.begin(), customers.end());
 
-    cout << "\nSuccess! Sampled, sorted data saved to ../results/ and ../data/ directories.\n";
+    ofstream out("../results/selection.csv");
+    out << "input,n,query,method,comparisons,assignments,median_ms,correct\n";
+    out << fixed << setprecision(3);
+    cout << fixed << setprecision(3);
+
+    cout << "\nSelection Engine (median, percentiles, top-" << TOP_K << " salaries)\n";
+    cout << "==========================================================\n";
+    compareSelection(out, "bank", customers, path);
+    compareSelection(out, "bank_x100", copies, "");
+
+    cout.unsetf(ios::fixed);
+    if (!closeOutput(out, "../results/selection.csv")) return false;
+    cout << "\nResults saved to ../results/selection.csv\n";
+    return true;
 }
 
 // ============================================================================
@@ -487,14 +1227,146 @@ void displayMenu() {
     cout << "\n";
     cout << "  3. Bank Customer Data Sorting with Sampling\n";
     cout << "\n";
-    cout << "  4. Exit\n";
+    cout << "  4. Parallel Quick Sort Scaling (speedup vs thread count)\n";
+    cout << "\n";
+    cout << "  5. Dictionary-Encoded Counting Sort (names, ages, country, gender)\n";
+    cout << "\n";
+    cout << "  6. String Sorts (multikey quicksort vs comparison sorts, character reads)\n";
+    cout << "\n";
+    cout << "  7. Quick Sort Pivot Policies (median-of-3, ninther, random, 3-way, introsort)\n";
+    cout << "\n";
+    cout << "  8. Hybrid Insertion Cutoff Sweep (merge and quick sort, cutoff 4..64)\n";
+    cout << "\n";
+    cout << "  9. Selection Engine (median, percentiles, top-k salaries without a full sort)\n";
+    cout << "\n";
+    cout << "  10. Exit\n";
     cout << "\n";
     cout << "----------------------------------------------------------\n";
-    cout << "Enter your choice (1-4): ";
+    cout << "Enter your choice (1-10): ";
+}
+
+/**
+ * @brief Runs menu option `choice` (1-9).
+ * @return 0 if the option succeeded, 1 if it failed (it has said why), -1 if there is no such option.
+ */
+int runOption(int choice) {
+    switch (choice) {
+        case 1:
+            return nameAgePerformanceAnalysis() ? 0 : 1;
+        case 2:
+            return bankCustomerSorting() ? 0 : 1;
+        case 3:
+            return bankCustomerSamplingSorting() ? 0 : 1;
+        case 4:
+            return parallelQuickSortScaling() ? 0 : 1;
+        case 5:
+            return dictionaryCountingSort() ? 0 : 1;
+        case 6:
+            return stringSortComparison() ? 0 : 1;
+        case 7:
+            return pivotPolicyComparison() ? 0 : 1;
+        case 8:
+            return cutoffSweep() ? 0 : 1;
+        case 9:
+            return selectionEngine() ? 0 : 1;
+        default:
+            return -1;
+    }
 }
 
-int main() {
+int main(int argc, char* argv[]) {
     int choice;
+
+    // Every argument must be one of the flags below, or the value of one
+    vector<string> options = {"--warmup", "--reps", "--pivot", "--cutoff", "--run"};
+    options.insert(options.end(), sweep::OPTIONS.begin(), sweep::OPTIONS.end());
+    string error;
+    if (!cli::checkFlags(argc, argv,
+                         {"--dumps", "--payloads", "--perf", "--index", "--radix", "--no-snapshot", "--async-write"},
+                         options, error)) {
+        cout << "Error: " << error << "\n";
+        return 1;
+    }
+
+    // Timing mode for option 1: --warmup W --reps R
+    bool valid = cli::intValue(argc, argv, "--warmup", timingConfig.warmup, 0, 1000000, error) &&
+                 cli::intValue(argc, argv, "--reps", timingConfig.repetitions, 1, 1000000, error);
+    // Per-dataset CSVs and sorted rows in results.jsonl for option 1: --dumps, --payloads
+    dumpDatasets = cli::has(argc, argv, "--dumps");
+    payloadMode = cli::has(argc, argv, "--payloads");
+    // Hardware counters for options 2 and 3: --perf
+    perfMode = cli::has(argc, argv, "--perf");
+    // Index (permutation) sort mode for options 2 and 3: --index
+    indexMode = cli::has(argc, argv, "--index");
+    // LSD radix sort on salary bits for options 2 and 3: --radix
+    radixMode = cli::has(argc, argv, "--radix");
+    // Quick sort variant for options 2 and 3, named as in option 7: --pivot introsort
+    if (const char* pivot = cli::value(argc, argv, "--pivot")) {
+        bool found = false;
+        for (const QuickVariant& v : quickVariants())
+            if (v.name == pivot) {
+                bankQuickOptions = v.options;
+                found = true;
+            }
+        if (!found) {
+            cout << "Error: unknown --pivot " << pivot << " (a variant name from option 7)\n";
+            return 1;
+        }
+    }
+    // Insertion sort below this many rows in the option 2 and 3 quick sort: --cutoff N
+    valid = valid && cli::intValue(argc, argv, "--cutoff", bankQuickOptions.cutoff, 1, 1 << 30, error);
+    // Always parse the bank CSV instead of loading <csv>.snap: --no-snapshot
+    useSnapshot = !cli::has(argc, argv, "--no-snapshot");
+    // Write the sorted bank CSV of option 2 on a background thread: --async-write
+    asyncWrite = cli::has(argc, argv, "--async-write");
+    // Parallel CSV parsing and bank sorts, sweep cells of options 1 and 3, max threads for option 4: --threads N
+    valid = valid && cli::intValue(argc, argv, "--threads", threadCount, 1, 1024, error);
+    // Run one menu option without the menu and exit: --run N
+    int option = 0;
+    valid = valid && cli::intValue(argc, argv, "--run", option, 1, 9, error);
+    if (!valid) {
+        cout << "Error: " << error << "\n";
+        return 1;
+    }
+    // --pivot and --cutoff only reach the serial quick sort: the radix sort has no pivot, and
+    // the parallel quick sort of option 2 has its own (ninther, three-way partition, depth limit)
+    const bool quickFlags = cli::has(argc, argv, "--pivot") || cli::has(argc, argv, "--cutoff");
+    if (quickFlags && radixMode) {
+        cout << "Error: --pivot and --cutoff choose the quick sort, which --radix replaces\n";
+        return 1;
+    }
+    if (quickFlags && threadCount > 1 && !indexMode)
+        cout << "Warning: option 2 sorts with the parallel quick sort on --threads " << threadCount
+             << ", which ignores --pivot and --cutoff; option 3 and --index still use them\n";
+    // Sweep of option 1 (sizes, datasets and seed also drive option 3): --n FROM:TO:STEP|FROM:TO:xFACTOR
+    // --datasets D --seed S --key age,name,combined --algorithm NAME --shape NAME --out DIR (see common/sweep.hpp)
+    sweepConfig.keys = {"age", "name", "combined"};
+    sweepConfig.algorithm = "quick_sort";
+    if (!sweep::parse(argc, argv, sweepConfig, error)) {
+        cout << "Error: " << error << "\n";
+        return 1;
+    }
+    for (const string& key : sweepConfig.keys) {
+        if (!findRecordKey(key)) {
+            cout << "Error: unknown --key " << key << " (age, name or combined)\n";
+            return 1;
+        }
+    }
+    if (sweepConfig.algorithm != "quick_sort") {
+        for (const QuickVariant& v : quickVariants())
+            if (v.name == sweepConfig.algorithm) {
+                recordQuickOptions = v.options;
+                recordQuickWith = true;
+            }
+        if (!recordQuickWith) {
+            cout << "Error: unknown --algorithm " << sweepConfig.algorithm
+                 << " (quick_sort or a variant name from option 7)\n";
+            return 1;
+        }
+    }
+
+    // --run 1, e.g. an unattended sweep
+    if (option) return runOption(option);
     
     while (true) {
         displayMenu();
@@ -503,31 +1375,15 @@ int main() {
         // Clear the input buffer
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-        switch (choice) {
-            case 1:
-                nameAgePerformanceAnalysis();
-                cout << "\nPress Enter to continue...";
-                cin.get();
-                break;
-                
-            case 2:
-                bankCustomerSorting();
-                cout << "\nPress Enter to continue...";
-                cin.get();
-                break;
-                
-            case 3:
-                bankCustomerSamplingSorting();
-                cout << "\nPress Enter to continue...";
-                cin.get();
-                break;
-
-            case 4:
-                cout << "\nExited!\n";
-                return 0;
-                
-            default:
-                cout << "\nInvalid choice! Please select 1-4.\n";
+        if (choice == 10) {
+            cout << "\nExited!\n";
+            return 0;
+        }
+        if (runOption(choice) >= 0) {
+            cout << "\nPress Enter to continue...";
+            cin.get();
+        } else {
+            cout << "\nInvalid choice! Please select 1-10.\n";
         }
     }
     
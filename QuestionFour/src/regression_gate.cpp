@@ -0,0 +1,310 @@
+/**
+ * @file regression_gate.cpp
+ * @brief Compares a benchmark run with a stored baseline and fails on regressions
+ * @details Reads two results.jsonl files (common/result_sink.hpp) and groups
+ *          their cells by (algorithm, key, shape, n). For every group present
+ *          in both it bootstraps a confidence interval of the ratio of medians
+ *          (new / baseline) and runs a one-sided Mann-Whitney test
+ *          (common/stats.hpp). A group regresses when the ratio exceeds
+ *          1 + threshold and the selected test finds the slowdown significant.
+ *          A group with fewer than --min-samples samples on either side (e.g.
+ *          one median_ns per cell from an old file) is reported as untested:
+ *          a bootstrap of one value is a single point, not an interval.
+ *          It also fits c * n log2 n and c * n^2 to the medians of every
+ *          (algorithm, key, shape) in each file and prints the constants.
+ *
+ *          Exit status: 0 if nothing regressed, 1 if some group regressed or
+ *          the new run lacks data the baseline has (unless --allow-missing),
+ *          2 if a file could not be read, the report could not be written, a
+ *          flag was malformed or no group could be tested.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <map>
+#include <tuple>
+#include <iomanip>
+#include <random>
+#include <cstdlib>
+#include <cmath>
+
+#include "../../common/cli.hpp"
+#include "../../common/result_reader.hpp"
+#include "../../common/stats.hpp"
+
+using namespace std;
+
+/**
+ * @struct GroupKey
+ * @brief The cells whose samples are pooled: one (algorithm, key, shape, n) over all datasets.
+ */
+struct GroupKey {
+    string algorithm, key, shape;
+    long long n;
+
+    bool operator<(const GroupKey& o) const {
+        return tie(algorithm, key, shape, n) < tie(o.algorithm, o.key, o.shape, o.n);
+    }
+};
+
+/// Samples of every group of one results file.
+using Groups = map<GroupKey, vector<double>>;
+
+/**
+ * @brief Pools the samples of `metric` from `rows` by group.
+ * @details `latency` takes each cell's raw `samples_ns`, or its `median_ns` for files
+ * written before cells had samples; any other metric is one numeric field per cell (e.g.
+ * `comparisons`). A cell whose `samples_ns` is empty has no latency data: its
+ * `median_ns` is 0, not a measurement. Cells without a shape (older files) count as uniform.
+ * @return The number of cells that did not have the metric.
+ */
+size_t collect(const vector<results::Row>& rows, const string& metric, Groups& groups) {
+    size_t missing = 0;
+    for (const results::Row& row : rows) {
+        const results::Cell& c = row.cell;
+        vector<double>& samples = groups[{c.algorithm, c.key, c.shape.empty() ? "uniform" : c.shape, c.n}];
+        const vector<double>* list = metric == "latency" ? row.list("samples_ns") : nullptr;
+        const double* value = row.value(metric == "latency" ? "median_ns" : metric);
+        if (list) {
+            if (list->empty()) missing++;
+            else samples.insert(samples.end(), list->begin(), list->end());
+        } else if (value) {
+            samples.push_back(*value);
+        } else {
+            missing++;
+        }
+    }
+    for (auto it = groups.begin(); it != groups.end();)
+        it = it->second.empty() ? groups.erase(it) : next(it);
+    return missing;
+}
+
+/**
+ * @brief Parses the number after `flag` into `out`, which keeps its value if the flag is absent.
+ * @return false if the value is not a finite number with nothing after it.
+ */
+bool doubleValue(int argc, char* argv[], const string& flag, double& out) {
+    const char* v = cli::value(argc, argv, flag);
+    if (!v) return !cli::has(argc, argv, flag);
+    char* end = nullptr;
+    double parsed = strtod(v, &end);
+    if (end == v || *end != '\0' || !isfinite(parsed)) return false;
+    out = parsed;
+    return true;
+}
+
+/**
+ * @brief Loads `path` into `groups`; prints the cell count or an error.
+ * @param missing Receives the number of cells without the metric.
+ * @return false if the file could not be opened.
+ */
+bool loadGroups(const string& label, const string& path, const string& metric, Groups& groups, size_t& missing) {
+    vector<results::Row> rows;
+    size_t skipped = 0;
+    if (!results::load(path, rows, &skipped)) {
+        cout << "Error: Could not open " << label << " file " << path << endl;
+        return false;
+    }
+    missing = collect(rows, metric, groups);
+    cout << left << setw(9) << label << right << rows.size() << " cells, " << groups.size() << " groups from "
+         << path;
+    if (skipped) cout << " (" << skipped << " malformed lines skipped)";
+    if (missing) cout << " (" << missing << " cells without " << metric << ")";
+    cout << "\n";
+    return true;
+}
+
+/**
+ * @brief Fits both growth models to the medians of each (algorithm, key, shape) of a run.
+ * @return For each series, the n log2 n fit and the n^2 fit.
+ */
+map<tuple<string, string, string>, pair<stats::Fit, stats::Fit>> fitSeries(const Groups& groups) {
+    map<tuple<string, string, string>, pair<vector<double>, vector<double>>> points;
+    for (const auto& [g, samples] : groups) {
+        auto& p = points[{g.algorithm, g.key, g.shape}];
+        p.first.push_back((double)g.n);
+        p.second.push_back(stats::median(samples));
+    }
+    map<tuple<string, string, string>, pair<stats::Fit, stats::Fit>> fits;
+    for (const auto& [series, p] : points)
+        fits[series] = {stats::fit(stats::Growth::NLogN, p.first, p.second),
+                        stats::fit(stats::Growth::NSquared, p.first, p.second)};
+    return fits;
+}
+
+/// @brief The model with the smaller relative error: "n log n" or "n^2".
+const char* betterModel(const pair<stats::Fit, stats::Fit>& f) {
+    return f.first.error <= f.second.error ? "n log n" : "n^2";
+}
+
+int main(int argc, char* argv[]) {
+    string error;
+    if (!cli::checkFlags(argc, argv, {"--allow-missing"},
+                         {"--baseline", "--new", "--metric", "--test", "--report", "--threshold", "--confidence",
+                          "--resamples", "--seed", "--min-samples"},
+                         error)) {
+        cout << "Error: " << error << "\n";
+        return 2;
+    }
+    // Files: --baseline PATH --new PATH; metric: --metric latency|comparisons|assignments|FIELD
+    string baselinePath = "../comparison_data/baseline/results.jsonl";
+    string newPath = "../results/results.jsonl";
+    string metric = "latency";
+    string test = "bootstrap";
+    string reportPath = "../results/regression_report.csv";
+    if (const char* v = cli::value(argc, argv, "--baseline")) baselinePath = v;
+    if (const char* v = cli::value(argc, argv, "--new")) newPath = v;
+    if (const char* v = cli::value(argc, argv, "--metric")) metric = v;
+    // Significance: --test bootstrap|mann-whitney at --confidence C; material change: --threshold T
+    if (const char* v = cli::value(argc, argv, "--test")) test = v;
+    if (const char* v = cli::value(argc, argv, "--report")) reportPath = v;
+    // Baseline groups or cells the new run lacks fail the gate unless --allow-missing
+    const bool allowMissing = cli::has(argc, argv, "--allow-missing");
+    double threshold = 0.10, confidence = 0.95;
+    if (!doubleValue(argc, argv, "--threshold", threshold) || !doubleValue(argc, argv, "--confidence", confidence)) {
+        cout << "Error: --threshold and --confidence take a number, e.g. 0.10 and 0.95\n";
+        return 2;
+    }
+    int resamples = 2000;
+    unsigned seed = 1;
+    // Groups with fewer samples than this on either side are untested rather than judged
+    size_t minSamples = 3;
+    if (!cli::intValue(argc, argv, "--resamples", resamples, 100, 10000000, error) ||
+        !cli::intValue(argc, argv, "--seed", seed, 0, 4294967295LL, error) ||
+        !cli::intValue(argc, argv, "--min-samples", minSamples, 1, 1000000, error)) {
+        cout << "Error: " << error << "\n";
+        return 2;
+    }
+    mt19937 rng(seed);
+
+    if (test != "bootstrap" && test != "mann-whitney") {
+        cout << "Error: unknown --test " << test << " (bootstrap or mann-whitney)\n";
+        return 2;
+    }
+    if (threshold < 0 || !(confidence > 0 && confidence < 1)) {
+        cout << "Error: want --threshold >= 0 and 0 < --confidence < 1\n";
+        return 2;
+    }
+
+    cout << "\nRegression Gate\n";
+    cout << "===============\n";
+    Groups baseline, candidate;
+    size_t baselineMissing = 0, newMissing = 0;
+    if (!loadGroups("Baseline", baselinePath, metric, baseline, baselineMissing) ||
+        !loadGroups("New", newPath, metric, candidate, newMissing))
+        return 2;
+    cout << "Metric: " << metric << ", test: " << test << " at " << confidence * 100
+         << "%, threshold: +" << threshold * 100 << "%\n\n";
+
+    ofstream report(reportPath);
+    if (!report) {
+        cout << "Error: Could not write report " << reportPath << endl;
+        return 2;
+    }
+    report << setprecision(10);
+    report << "algorithm,key,shape,n,baseline_samples,new_samples,baseline_median,new_median,"
+              "ratio,ci_low,ci_high,mann_whitney_p,verdict\n";
+
+    const double alpha = 1 - confidence;
+    size_t compared = 0, regressed = 0, improved = 0, untested = 0, dropped = 0, added = 0;
+    cout << left << setw(16) << "algorithm" << setw(10) << "key" << setw(14) << "shape" << right << setw(10) << "n"
+         << setw(10) << "ratio" << "  interval           p(slower) verdict\n";
+    cout << fixed;
+    for (const auto& [g, base] : baseline) {
+        auto it = candidate.find(g);
+        if (it == candidate.end()) {
+            dropped++;
+            report << g.algorithm << "," << g.key << "," << g.shape << "," << g.n << "," << base.size()
+                   << ",0," << stats::median(base) << ",,,,,,missing\n";
+            cout << left << setw(16) << g.algorithm << setw(10) << g.key << setw(14) << g.shape << right
+                 << setw(10) << g.n << "  missing from the new run\n";
+            continue;
+        }
+        const vector<double>& fresh = it->second;
+        if (base.size() < minSamples || fresh.size() < minSamples) {
+            untested++;
+            report << g.algorithm << "," << g.key << "," << g.shape << "," << g.n << "," << base.size() << ","
+                   << fresh.size() << "," << stats::median(base) << "," << stats::median(fresh) << ","
+                   << stats::median(fresh) / stats::median(base) << ",,,,untested\n";
+            cout << left << setw(16) << g.algorithm << setw(10) << g.key << setw(14) << g.shape << right
+                 << setw(10) << g.n << "  untested: " << base.size() << " baseline and " << fresh.size()
+                 << " new samples (--min-samples " << minSamples << ")\n";
+            continue;
+        }
+        stats::Interval ratio = stats::bootstrapRatio(base, fresh, confidence, resamples, rng);
+        double slower = stats::mannWhitney(base, fresh), faster = stats::mannWhitney(fresh, base);
+        bool slowerSignificant = test == "bootstrap" ? ratio.low > 1 : slower < alpha;
+        bool fasterSignificant = test == "bootstrap" ? ratio.high < 1 : faster < alpha;
+
+        string verdict = "unchanged";
+        if (ratio.estimate > 1 + threshold && slowerSignificant) verdict = "regressed";
+        else if (ratio.estimate < 1 / (1 + threshold) && fasterSignificant) verdict = "improved";
+        compared++;
+        regressed += verdict == "regressed";
+        improved += verdict == "improved";
+
+        report << g.algorithm << "," << g.key << "," << g.shape << "," << g.n << "," << base.size() << ","
+               << fresh.size() << "," << stats::median(base) << "," << stats::median(fresh) << "," << ratio.estimate
+               << "," << ratio.low << "," << ratio.high << "," << slower << "," << verdict << "\n";
+        if (verdict == "unchanged") continue;
+        cout << left << setw(16) << g.algorithm << setw(10) << g.key << setw(14) << g.shape << right << setw(10)
+             << g.n << setprecision(3) << setw(10) << ratio.estimate << "  [" << ratio.low << ", " << ratio.high
+             << "]  " << setprecision(4) << setw(9) << slower << " " << verdict << "\n";
+    }
+    for (const auto& entry : candidate)
+        if (!baseline.count(entry.first)) added++;
+    if (regressed + improved + untested + dropped == 0) cout << "  (no group changed by more than the threshold)\n";
+
+    // Growth constants per series, from the medians of each n
+    auto baseFits = fitSeries(baseline), newFits = fitSeries(candidate);
+    cout << "\nGrowth fits (medians ~ c * f(n); error is the relative RMS residual)\n";
+    cout << left << setw(16) << "algorithm" << setw(10) << "key" << setw(14) << "shape" << setw(9) << "model"
+         << right << setw(14) << "baseline c" << setw(14) << "new c" << setw(10) << "change" << "\n";
+    cout.unsetf(ios::fixed);
+    for (const auto& [series, fit] : newFits) {
+        auto base = baseFits.find(series);
+        if (base == baseFits.end()) continue;
+        const bool nlogn = fit.first.error <= fit.second.error;
+        const stats::Fit& b = nlogn ? base->second.first : base->second.second;
+        const stats::Fit& c = nlogn ? fit.first : fit.second;
+        cout << left << setw(16) << get<0>(series) << setw(10) << get<1>(series) << setw(14) << get<2>(series)
+             << setw(9) << betterModel(fit) << right << setprecision(4) << setw(14) << b.constant << setw(14)
+             << c.constant << setw(9) << fixed << setprecision(1)
+             << (b.constant != 0 ? (c.constant / b.constant - 1) * 100 : 0.0) << "%";
+        if (string(betterModel(base->second)) != betterModel(fit))
+            cout << "  (baseline fits " << betterModel(base->second) << ")";
+        cout << "\n";
+        cout.unsetf(ios::fixed);
+    }
+
+    cout << "\n" << compared << " groups compared, " << regressed << " regressed, " << improved << " improved";
+    if (untested) cout << ", " << untested << " untested (too few samples)";
+    if (dropped) cout << ", " << dropped << " missing from the new run";
+    if (added) cout << ", " << added << " only in the new run";
+    report.close();
+    if (!report) {
+        cout << "\nError: Could not write report " << reportPath << endl;
+        return 2;
+    }
+    cout << "\nReport saved to " << reportPath << "\n";
+    if (compared == 0) {
+        cout << "Error: no group is in both files with at least " << minSamples << " samples of " << metric
+             << " data, so nothing was compared\n";
+        return 2;
+    }
+    bool fail = regressed > 0;
+    if (regressed) cout << "FAIL: " << regressed << " group" << (regressed > 1 ? "s" : "") << " regressed\n";
+    if (dropped + newMissing > 0 && !allowMissing) {
+        cout << "FAIL: the new run lacks";
+        if (dropped) cout << " " << dropped << " baseline group" << (dropped == 1 ? "" : "s");
+        if (dropped && newMissing) cout << " and";
+        if (newMissing) cout << " " << metric << " data in " << newMissing << " cell" << (newMissing == 1 ? "" : "s");
+        cout << " (--allow-missing to accept)\n";
+        fail = true;
+    }
+    if (fail) return 1;
+    cout << "PASS\n";
+    return 0;
+}
@@ -11,6 +11,10 @@
 #include <iomanip>
 #include <ctime>
 
+#include "../../common/cli.hpp"
+#include "../../common/sorting.hpp"
+#include "../../common/timing.hpp"
+
 using namespace std;
 
 struct Record {
@@ -21,6 +25,11 @@ struct Record {
 long long comparisons = 0;
 long long assignments = 0;
 
+// Sort keys and the counting policy shared by all three sorts
+using ByAge = sorting::Key<sorting::Field<&Record::age>>;
+using ByName = sorting::Key<sorting::Field<&Record::name>>;
+const sorting::CountOps ops{&comparisons, &assignments};
+
 // Pools for generating data with duplicates
 const vector<string> NAMES = {
     "Amit", "Priya", "Rahul", "Sneha", "Vikram", "Anita", "Ravi", "Meera",
@@ -41,72 +50,27 @@ vector<Record> generateData(int n, mt19937& rng) {
     return data;
 }
 
-/// @brief Sort by age (ascending)
-void sortByAge(vector<Record>& data) {
-    for (size_t i = 1; i < data.size(); i++) {
-        Record key = data[i];
-        assignments++;
-        int j = i - 1;
-        while (j >= 0 && (comparisons++, data[j].age > key.age)) {
-            data[j + 1] = data[j];
-            assignments++;
-            j--;
-        }
-        data[j + 1] = key;
-        assignments++;
-    }
+/// @brief Sort by name then age : age pass first, then a stable pass by name
+template <class Policy>
+void sortByNameThenAge(vector<Record>& data, const Policy& p) {
+    sorting::insertionSort(data, ByAge(), p);
+    sorting::insertionSort(data, ByName(), p);
 }
 
-/// @brief Sort by name (ascending)
-void sortByName(vector<Record>& data) {
-    for (size_t i = 1; i < data.size(); i++) {
-        Record key = data[i];
-        assignments++;
-        int j = i - 1;
-        while (j >= 0 && (comparisons++, data[j].name > key.name)) {
-            data[j + 1] = data[j];
-            assignments++;
-            j--;
-        }
-        data[j + 1] = key;
-        assignments++;
-    }
-}
-
-/// @brief Stable Sort by name then age : maintains age order within same names)
-void sortByNameThenAge(vector<Record>& data) {
-    // First sort by age
-    for (size_t i = 1; i < data.size(); i++) {
-        Record key = data[i];
-        assignments++;
-        int j = i - 1;
-        while (j >= 0 && (comparisons++, data[j].age > key.age)) {
-            data[j + 1] = data[j];
-            assignments++;
-            j--;
-        }
-        data[j + 1] = key;
-        assignments++;
-    }
-    // Stable sort by name
-    for (size_t i = 1; i < data.size(); i++) {
-        Record key = data[i];
-        assignments++;
-        int j = i - 1;
-        while (j >= 0 && (comparisons++, data[j].name > key.name)) {
-            data[j + 1] = data[j];
-            assignments++;
-            j--;
-        }
-        data[j + 1] = key;
-        assignments++;
-    }
-}
-
-int main() {
+int main(int argc, char* argv[]) {
     mt19937 rng(time(nullptr));
     
     const int DATASETS = 10;
+
+    // Timing mode: --warmup W --reps R (uncounted sorts, steady_clock)
+    timing::Config timingConfig;
+    string error;
+    if (!cli::checkFlags(argc, argv, {}, {"--warmup", "--reps"}, error) ||
+        !cli::intValue(argc, argv, "--warmup", timingConfig.warmup, 0, 1000000, error) ||
+        !cli::intValue(argc, argv, "--reps", timingConfig.repetitions, 1, 1000000, error)) {
+        cout << "Error: " << error << "\n";
+        return 1;
+    }
     
     // Open output files
     ofstream fAge("../results/sort_by_age.csv");
@@ -123,7 +87,8 @@ int main() {
     fAgeAssign << "n,dataset,assignments\n";
     fNameAssign << "n,dataset,assignments\n";
     fCombinedAssign << "n,dataset,assignments\n";
-    fSummary << "n,avg_age_comp,avg_name_comp,avg_combined_comp,avg_age_assign,avg_name_assign,avg_combined_assign\n";
+    fSummary << "n,avg_age_comp,avg_name_comp,avg_combined_comp,avg_age_assign,avg_name_assign,avg_combined_assign,"
+             << timing::header("age") << "," << timing::header("name") << "," << timing::header("combined") << "\n";
     
     cout << "Insertion Sort \n";
     cout << "=========================\n\n";
@@ -131,6 +96,7 @@ int main() {
     for (int n = 10; n <= 100; n += 10) {
         long long totalAge = 0, totalName = 0, totalCombined = 0;
         long long totalAgeAssign = 0, totalNameAssign = 0, totalCombinedAssign = 0;
+        vector<double> ageTimes, nameTimes, combinedTimes;
         
         cout << "n = " << setw(3) << n << ": ";
         
@@ -148,7 +114,7 @@ int main() {
             vector<Record> data = original;
             comparisons = 0;
             assignments = 0;
-            sortByAge(data);
+            sorting::insertionSort(data, ByAge(), ops);
             fAge << n << "," << d+1 << "," << comparisons << "\n";
             fAgeAssign << n << "," << d+1 << "," << assignments << "\n";
             totalAge += comparisons;
@@ -166,7 +132,7 @@ int main() {
             data = original;
             comparisons = 0;
             assignments = 0;
-            sortByName(data);
+            sorting::insertionSort(data, ByName(), ops);
             fName << n << "," << d+1 << "," << comparisons << "\n";
             fNameAssign << n << "," << d+1 << "," << assignments << "\n";
             totalName += comparisons;
@@ -184,7 +150,7 @@ int main() {
             data = original;
             comparisons = 0;
             assignments = 0;
-            sortByNameThenAge(data);
+            sortByNameThenAge(data, ops);
             fCombined << n << "," << d+1 << "," << comparisons << "\n";
             fCombinedAssign << n << "," << d+1 << "," << assignments << "\n";
             totalCombined += comparisons;
@@ -198,6 +164,14 @@ int main() {
                     fSortedCombined << r.name << "," << fixed << setprecision(1) << r.age << "\n";
             }
             
+            // Wall-clock latency of the same three sorts, uncounted
+            timing::sample(original, [](vector<Record>& v) { sorting::insertionSort(v, ByAge()); },
+                           timingConfig, ageTimes);
+            timing::sample(original, [](vector<Record>& v) { sorting::insertionSort(v, ByName()); },
+                           timingConfig, nameTimes);
+            timing::sample(original, [](vector<Record>& v) { sortByNameThenAge(v, sorting::NoCount()); },
+                           timingConfig, combinedTimes);
+            
             cout << ".";
         }
         
@@ -210,7 +184,11 @@ int main() {
         
         fSummary << n << "," << fixed << setprecision(2) 
                  << avgAge << "," << avgName << "," << avgCombined << ","
-                 << avgAgeAssign << "," << avgNameAssign << "," << avgCombinedAssign << "\n";
+                 << avgAgeAssign << "," << avgNameAssign << "," << avgCombinedAssign;
+        timing::writeStats(fSummary, timing::summarize(ageTimes));
+        timing::writeStats(fSummary, timing::summarize(nameTimes));
+        timing::writeStats(fSummary, timing::summarize(combinedTimes));
+        fSummary << "\n";
         
         cout << " Avg: Age=" << avgAge << ", Name=" << avgName 
              << ", Combined=" << avgCombined << "\n";
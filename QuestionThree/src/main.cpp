@@ -8,12 +8,31 @@
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
 #include <iomanip>
 #include <random>
 #include <ctime>
+#include <memory>
+#include <algorithm>
+#include <filesystem>
+
+#include "../../common/bank_loader.hpp"
+#include "../../common/bank_snapshot.hpp"
+#include "../../common/cli.hpp"
+#include "../../common/csv_writer.hpp"
+#include "../../common/customer.hpp"
+#include "../../common/external_sort.hpp"
+#include "../../common/generators.hpp"
+#include "../../common/index_sort.hpp"
+#include "../../common/parallel_sort.hpp"
+#include "../../common/perf_counters.hpp"
+#include "../../common/radix_sort.hpp"
+#include "../../common/result_sink.hpp"
+#include "../../common/sorting.hpp"
+#include "../../common/sweep.hpp"
+#include "../../common/timsort.hpp"
+#include "../../common/timing.hpp"
 
 using namespace std;
 
@@ -33,6 +52,59 @@ struct Record {
 long long comparisons = 0; ///< Global counter for comparisons.
 long long assignments = 0; ///< Global counter for assignments.
 
+/// Sort keys: compile-time projections onto Record fields.
+using ByAge = sorting::Key<sorting::Field<&Record::age>>;
+using ByName = sorting::Key<sorting::Field<&Record::name>>;
+using ByNameThenAge = sorting::ThenBy<ByName, ByAge>;
+
+/// Counting policy feeding the global counters above.
+const sorting::CountOps ops{&comparisons, &assignments};
+
+/// Warm-up/repetition counts for the latency columns (set from the command line).
+timing::Config timingConfig;
+/// Also write every generated and sorted dataset of option 1 to its own CSV (set with --dumps).
+bool dumpDatasets = false;
+/// Store the sorted rows of every option 1 cell in results.jsonl (set with --payloads).
+bool payloadMode = false;
+/// Sizes, datasets, seed, keys, algorithm and output directory of option 1 (common/sweep.hpp).
+sweep::Config sweepConfig;
+
+/// Merge sort variants option 1 can run, named as in RECORD_SORTS (set with --algorithm).
+enum class RecordSort { Merge, Buffered, BottomUp, Tim };
+const vector<string> RECORD_SORTS = {"merge_sort", "merge_sort_buffered", "merge_sort_bottom_up", "timsort"};
+/// The option 1 algorithm.
+RecordSort recordSort = RecordSort::Merge;
+
+/// @brief Sorts `data` by `key` with the option 1 algorithm, counting through `p`.
+template <class K, class Policy = sorting::NoCount>
+void sortRecords(vector<Record>& data, const K& key, const Policy& p = Policy()) {
+    switch (recordSort) {
+        case RecordSort::Merge: sorting::mergeSort(data, key, p); break;
+        case RecordSort::Buffered: sorting::mergeSortBuffered(data, key, p); break;
+        case RecordSort::BottomUp: sorting::mergeSortBottomUp(data, key, p); break;
+        case RecordSort::Tim: sorting::timSort(data, key, p); break;
+    }
+}
+
+/**
+ * @struct RecordKey
+ * @brief An option 1 sort key: its --key name, console label and result file stem.
+ */
+struct RecordKey {
+    const char* name;
+    const char* label;
+    const char* file;
+};
+const RecordKey RECORD_KEYS[] = {
+    {"age", "Age", "sort_by_age"}, {"name", "Name", "sort_by_name"}, {"combined", "Combined", "sort_combined"}};
+
+/// @brief The RECORD_KEYS entry called `name`, or nullptr.
+const RecordKey* findRecordKey(const string& name) {
+    for (const RecordKey& k : RECORD_KEYS)
+        if (name == k.name) return &k;
+    return nullptr;
+}
+
 ///< Sample names for data generation.
 const vector<string> NAMES = {
     "Amit", "Priya", "Rahul", "Sneha", "Vikram", "Anita", "Ravi", "Meera",
@@ -44,418 +116,420 @@ const vector<float> AGES = {
     21.0f, 21.5f, 22.0f, 22.5f, 23.0f, 23.5f, 17.8f, 19.8f
 };
 
+/**
+ * @brief Draws one record: a name and an age from the pools, at indices from `pick`.
+ */
+Record drawRecord(gen::Picker& pick) {
+    Record r;
+    r.name = NAMES[pick(NAMES.size())];
+    r.age = AGES[pick(AGES.size())];
+    return r;
+}
+
 /**
  * @brief Generates a vector of random Record data.
  * @param n The number of records to generate.
  * @param rng The random number generator.
+ * @param shape Input distribution (common/generators.hpp); sorted-like shapes are ordered by `key`.
  * @return A vector of generated records.
  */
-vector<Record> generateData(int n, mt19937& rng) {
-    vector<Record> data(n);
-    for (int i = 0; i < n; i++) {
-        data[i].name = NAMES[rng() % NAMES.size()];
-        data[i].age = AGES[rng() % AGES.size()];
-    }
-    return data;
+template <class K = ByAge>
+vector<Record> generateData(long long n, mt19937& rng, gen::Shape shape = gen::Shape::Uniform, const K& key = K()) {
+    return gen::generate<Record>(shape, n, rng, drawRecord, key);
 }
 
 /**
- * @brief Merges two subarrays of Records, sorted by age.
- * @param data The vector of Records.
- * @param left The starting index of the first subarray.
- * @param mid The ending index of the first subarray.
- * @param right The ending index of the second subarray.
+ * @brief Writes `records` to `path` as "name,age" lines, age with one decimal.
+ * @param header Start with the "name,age" header line.
+ * @return false if the file could not be opened or written.
  */
-void mergeByAge(vector<Record>& data, int left, int mid, int right) {
-    vector<Record> temp(right - left + 1);
-    int i = left, j = mid + 1, k = 0;
-
-    while (i <= mid && j <= right) {
-        comparisons++;
-        if (data[i].age <= data[j].age) {
-            temp[k++] = data[i++];
-        } else {
-            temp[k++] = data[j++];
-        }
-        assignments++;
-    }
-
-    while (i <= mid) {
-        temp[k++] = data[i++];
-        assignments++;
-    }
-    while (j <= right) {
-        temp[k++] = data[j++];
-        assignments++;
-    }
-
-    for (int l = 0; l < temp.size(); l++) {
-        data[left + l] = temp[l];
-        assignments++;
-    }
+bool writeRecords(const string& path, const vector<Record>& records, bool header) {
+    csv::Writer out(path, 64 << 10);
+    if (header) out.put("name,age\n");
+    for (const Record& r : records)
+        out.put(r.name).put(',').fixed(r.age, 1).put('\n');
+    return out.finish();
 }
 
 /**
- * @brief Sorts a vector of Records by age using merge sort.
- * @param data The vector of Records to sort.
- * @param left The starting index of the array to be sorted.
- * @param right The ending index of the array to be sorted.
+ * @brief Closes `out`, which was writing `path`, and checks that every line got there.
+ * @return false (after printing an error) if the file did not open or a write failed.
  */
-void mergeSortByAge(vector<Record>& data, int left, int right) {
-    if (left < right) {
-        int mid = left + (right - left) / 2;
-        mergeSortByAge(data, left, mid);
-        mergeSortByAge(data, mid + 1, right);
-        mergeByAge(data, left, mid, right);
-    }
+bool closeOutput(ofstream& out, const string& path) {
+    out.close();
+    if (out) return true;
+    cout << "\nError: Could not write " << path << "\n";
+    return false;
 }
 
 /**
- * @brief Merges two subarrays of Records, sorted by name.
- * @param data The vector of Records.
- * @param left The starting index of the first subarray.
- * @param mid The ending index of the first subarray.
- * @param right The ending index of the second subarray.
+ * @struct CellResult
+ * @brief What one (key, n, dataset) cell of option 1 measured.
  */
-void mergeByName(vector<Record>& data, int left, int mid, int right) {
-    vector<Record> temp(right - left + 1);
-    int i = left, j = mid + 1, k = 0;
-
-    while (i <= mid && j <= right) {
-        comparisons++;
-        if (data[i].name <= data[j].name) {
-            temp[k++] = data[i++];
-        } else {
-            temp[k++] = data[j++];
-        }
-        assignments++;
-    }
-
-    while (i <= mid) {
-        temp[k++] = data[i++];
-        assignments++;
-    }
-    while (j <= right) {
-        temp[k++] = data[j++];
-        assignments++;
-    }
-
-    for (int l = 0; l < temp.size(); l++) {
-        data[left + l] = temp[l];
-        assignments++;
-    }
-}
+struct CellResult {
+    long long comparisons = 0;
+    long long assignments = 0;
+    vector<double> times;  ///< Latency samples (ns) of the uncounted sorts.
+    vector<Record> sorted; ///< The sorted rows, kept only with --payloads.
+    string unwritten;      ///< A --dumps file of this cell that could not be written.
+};
 
 /**
- * @brief Sorts a vector of Records by name using merge sort.
- * @param data The vector of Records to sort.
- * @param left The starting index of the array to be sorted.
- * @param right The ending index of the array to be sorted.
+ * @brief Appends one (key, n, dataset) cell of option 1 to the results file.
+ * @details Holds the base seed, the counters, the median of the cell's latency samples,
+ * the samples themselves (for regression_gate) and, with --payloads, the sorted rows.
  */
-void mergeSortByName(vector<Record>& data, int left, int right) {
-    if (left < right) {
-        int mid = left + (right - left) / 2;
-        mergeSortByName(data, left, mid);
-        mergeSortByName(data, mid + 1, right);
-        mergeByName(data, left, mid, right);
-    }
+void saveCell(results::Sink& sink, const char* key, long long n, int dataset, const CellResult& cell) {
+    sink.begin({sweepConfig.algorithm, key, n, dataset, gen::name(sweepConfig.shape)})
+        .field("seed", sweepConfig.seed)
+        .field("comparisons", cell.comparisons)
+        .field("assignments", cell.assignments)
+        .field("median_ns", timing::summarize(cell.times).median)
+        .field("samples_ns", cell.times)
+        .payload(cell.sorted, [](results::Sink::Tuple& row, const Record& r) { row.value(r.name).value(r.age, 1); });
+    sink.end();
 }
 
 /**
- * @brief Merges two subarrays of Records, sorted first by name, then by age.
- * @param data The vector of Records.
- * @param left The starting index of the first subarray.
- * @param mid The ending index of the first subarray.
- * @param right The ending index of the second subarray.
+ * @brief Runs performance analysis for merge sort on Name-Age records.
+ * @details For every size and dataset of the sweep (by default n = 10, 20, ..., 100 with
+ * 10 datasets each), generates records and sorts them by each selected key: the uncounted
+ * latency samples first, then one counted sort for comparisons and assignments. Each
+ * (key, n, dataset) cell generates its records from its own seed (sweep::cellRng) and the
+ * cells run on --threads threads; results are written in cell order, so every file except
+ * the latency columns is the same for any thread count. Per-key CSVs, summary.csv and
+ * results.jsonl go to the --out directory; --dumps datasets go to sweep::Config::dataDir().
  */
-void mergeByNameThenAge(vector<Record>& data, int left, int mid, int right) {
-    vector<Record> temp(right - left + 1);
-    int i = left, j = mid + 1, k = 0;
-
-    while (i <= mid && j <= right) {
-        comparisons++;
-        if (data[i].name < data[j].name) {
-            temp[k++] = data[i++];
-            assignments++;
-        } else if (data[i].name > data[j].name) {
-            temp[k++] = data[j++];
-            assignments++;
-        } else {
-            comparisons++;
-            if (data[i].age <= data[j].age) {
-                temp[k++] = data[i++];
-            } else {
-                temp[k++] = data[j++];
-            }
-            assignments++;
-        }
-    }
+bool nameAgePerformanceAnalysis() {
+    const sweep::Config& cfg = sweepConfig;
+    const string dir = cfg.outDir + "/";
+    const string dataDir = cfg.dataDir() + "/";
+    error_code ec;
+    filesystem::create_directories(cfg.outDir, ec);
+    if (dumpDatasets) filesystem::create_directories(cfg.dataDir(), ec);
 
-    while (i <= mid) {
-        temp[k++] = data[i++];
-        assignments++;
-    }
-    while (j <= right) {
-        temp[k++] = data[j++];
-        assignments++;
+    // Per-key result files and the running totals of the current size
+    struct KeyRun {
+        const RecordKey* key;
+        ofstream comps, assigns;
+        long long totalComp = 0, totalAssign = 0;
+        vector<double> times;
+    };
+    vector<KeyRun> runs(cfg.keys.size());
+    for (size_t i = 0; i < runs.size(); i++) {
+        KeyRun& run = runs[i];
+        run.key = findRecordKey(cfg.keys[i]);
+        run.comps.open(dir + run.key->file + ".csv");
+        run.assigns.open(dir + run.key->file + "_assignments.csv");
+        run.comps << "n,dataset,comparisons\n";
+        run.assigns << "n,dataset,assignments\n";
     }
+    ofstream fSummary(dir + "summary.csv");
+    results::Sink sink(dir + "results.jsonl", payloadMode);
 
-    for (int l = 0; l < temp.size(); l++) {
-        data[left + l] = temp[l];
-        assignments++;
-    }
-}
+    fSummary << "n";
+    for (const KeyRun& run : runs) fSummary << ",avg_" << run.key->name << "_comp";
+    for (const KeyRun& run : runs) fSummary << ",avg_" << run.key->name << "_assign";
+    for (const KeyRun& run : runs) fSummary << "," << timing::header(run.key->name);
+    fSummary << "\n";
 
-/**
- * @brief Sorts a vector of Records by name then age using merge sort.
- * @param data The vector of Records to sort.
- * @param left The starting index of the array to be sorted.
- * @param right The ending index of the array to be sorted.
- */
-void mergeSortByNameThenAge(vector<Record>& data, int left, int right) {
-    if (left < right) {
-        int mid = left + (right - left) / 2;
-        mergeSortByNameThenAge(data, left, mid);
-        mergeSortByNameThenAge(data, mid + 1, right);
-        mergeByNameThenAge(data, left, mid, right);
-    }
-}
+    // Cells are numbered size-major, then dataset, then key (the order of a serial loop)
+    const vector<long long> sizes = cfg.sizes.values();
+    const size_t keys = runs.size();
+    const size_t perSize = keys * cfg.datasets;
+    auto sizeOf = [&](size_t cell) { return sizes[cell / perSize]; };
+    auto datasetOf = [&](size_t cell) { return (int)(cell % perSize / keys) + 1; };
 
-/**
- * @brief Runs performance analysis for merge sort on Name-Age records.
- * @details Generates datasets, sorts them by age, name, and a combination of name and age.
- * It records the number of comparisons and assignments for each sort and saves the results to CSV files.
- */
-void nameAgePerformanceAnalysis() {
-    mt19937 rng(time(nullptr));
-    
-    const int DATASETS = 10;
-    
-    ofstream fAge("../results/sort_by_age.csv");
-    ofstream fName("../results/sort_by_name.csv");
-    ofstream fCombined("../results/sort_combined.csv");
-    ofstream fAgeAssign("../results/sort_by_age_assignments.csv");
-    ofstream fNameAssign("../results/sort_by_name_assignments.csv");
-    ofstream fCombinedAssign("../results/sort_combined_assignments.csv");
-    ofstream fSummary("../results/summary.csv");
-    
-    fAge << "n,dataset,comparisons\n";
-    fName << "n,dataset,comparisons\n";
-    fCombined << "n,dataset,comparisons\n";
-    fAgeAssign << "n,dataset,assignments\n";
-    fNameAssign << "n,dataset,assignments\n";
-    fCombinedAssign << "n,dataset,assignments\n";
-    fSummary << "n,avg_age_comp,avg_name_comp,avg_combined_comp,avg_age_assign,avg_name_assign,avg_combined_assign\n";
-    
-    cout << "\nMerge Sort Performance Analysis (Name-Age Records)\n";
-    cout << "===================================================\n\n";
-    
-    for (int n = 10; n <= 100; n += 10) {
-        long long totalAge = 0, totalName = 0, totalCombined = 0;
-        long long totalAgeAssign = 0, totalNameAssign = 0, totalCombinedAssign = 0;
-        
-        cout << "n = " << setw(3) << n << ": ";
-        
-        for (int d = 0; d < DATASETS; d++) {
-            vector<Record> original = generateData(n, rng);
-            
-            ofstream fData("../data/dataset_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            for (auto& r : original)
-                fData << r.name << "," << fixed << setprecision(1) << r.age << "\n";
-            
-            // Sort by age
-            vector<Record> data = original;
-            comparisons = 0;
-            assignments = 0;
-            if (data.size() > 0)
-                mergeSortByAge(data, 0, data.size() - 1);
-            fAge << n << "," << d+1 << "," << comparisons << "\n";
-            fAgeAssign << n << "," << d+1 << "," << assignments << "\n";
-            totalAge += comparisons;
-            totalAgeAssign += assignments;
-            
-            ofstream fSortedAge("../results/sorted_by_age_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            fSortedAge << "name,age\n";
-            for (auto& r : data)
-                fSortedAge << r.name << "," << fixed << setprecision(1) << r.age << "\n";
-
-            // Sort by name
-            data = original;
-            comparisons = 0;
-            assignments = 0;
-            if (data.size() > 0)
-                mergeSortByName(data, 0, data.size() - 1);
-            fName << n << "," << d+1 << "," << comparisons << "\n";
-            fNameAssign << n << "," << d+1 << "," << assignments << "\n";
-            totalName += comparisons;
-            totalNameAssign += assignments;
-            
-            ofstream fSortedName("../results/sorted_by_name_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            fSortedName << "name,age\n";
-            for (auto& r : data)
-                fSortedName << r.name << "," << fixed << setprecision(1) << r.age << "\n";
-
-            // Combined sort
-            data = original;
-            comparisons = 0;
-            assignments = 0;
-            if (data.size() > 0)
-                mergeSortByNameThenAge(data, 0, data.size() - 1);
-            fCombined << n << "," << d+1 << "," << comparisons << "\n";
-            fCombinedAssign << n << "," << d+1 << "," << assignments << "\n";
-            totalCombined += comparisons;
-            totalCombinedAssign += assignments;
-            
-            ofstream fSortedCombined("../results/sorted_combined_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            fSortedCombined << "name,age\n";
-            for (auto& r : data)
-                fSortedCombined << r.name << "," << fixed << setprecision(1) << r.age << "\n";
-
-            cout << ".";
+    // Latency samples, then the counted sort, of one dataset by one key
+    auto measure = [&](auto key, const vector<Record>& original, const RecordKey& recordKey, long long n, int d) {
+        CellResult result;
+        timing::sample(original, [&key](vector<Record>& v) { sortRecords(v, key); }, timingConfig, result.times);
+
+        vector<Record> data = original;
+        sortRecords(data, key, sorting::CountOps{&result.comparisons, &result.assignments});
+        if (dumpDatasets) {
+            string path = dir + "sorted" + (recordKey.file + 4) + "_n" + to_string(n) + "_d" + to_string(d) + ".csv";
+            if (!writeRecords(path, data, true)) result.unwritten = path;
         }
-        
-        double avgAge = (double)totalAge / DATASETS;
-        double avgName = (double)totalName / DATASETS;
-        double avgCombined = (double)totalCombined / DATASETS;
-        double avgAgeAssign = (double)totalAgeAssign / DATASETS;
-        double avgNameAssign = (double)totalNameAssign / DATASETS;
-        double avgCombinedAssign = (double)totalCombinedAssign / DATASETS;
-        
-        fSummary << n << "," << fixed << setprecision(2) 
-                 << avgAge << "," << avgName << "," << avgCombined << ","
-                 << avgAgeAssign << "," << avgNameAssign << "," << avgCombinedAssign << "\n";
-        
-        cout << " Avg: Age=" << avgAge << ", Name=" << avgName 
-             << ", Combined=" << avgCombined << "\n";
+        if (payloadMode) result.sorted = move(data);
+        return result;
+    };
+
+    // Runs on a pool thread: touches nothing shared but its own dump files
+    auto runCell = [&](size_t cell) {
+        const long long n = sizeOf(cell);
+        const int d = datasetOf(cell);
+        const RecordKey& key = *runs[cell % keys].key;
+        mt19937 rng = sweep::cellRng(cfg.seed, n, d);
+
+        // Sorted-like shapes are ordered by the key this cell sorts by
+        auto generateAndMeasure = [&](auto sortKey) {
+            vector<Record> original = generateData(n, rng, cfg.shape, sortKey);
+            string unwritten;
+            if (dumpDatasets && cell % keys == 0) {
+                string path = dataDir + "dataset_n" + to_string(n) + "_d" + to_string(d) + ".csv";
+                if (!writeRecords(path, original, false)) unwritten = path;
+            }
+            CellResult result = measure(sortKey, original, key, n, d);
+            if (!unwritten.empty()) result.unwritten = unwritten;
+            return result;
+        };
+        if (&key == &RECORD_KEYS[0]) return generateAndMeasure(ByAge());
+        if (&key == &RECORD_KEYS[1]) return generateAndMeasure(ByName());
+        return generateAndMeasure(ByNameThenAge());
+    };
+
+    // Runs on this thread, in cell order
+    size_t unwritten = 0;
+    string firstUnwritten;
+    auto emit = [&](size_t cell, CellResult result) {
+        const long long n = sizeOf(cell);
+        const int d = datasetOf(cell);
+        KeyRun& run = runs[cell % keys];
+        if (!result.unwritten.empty() && unwritten++ == 0) firstUnwritten = result.unwritten;
+        if (cell % perSize == 0) cout << "n = " << setw(3) << n << ": " << flush;
+
+        run.comps << n << "," << d << "," << result.comparisons << "\n";
+        run.assigns << n << "," << d << "," << result.assignments << "\n";
+        run.totalComp += result.comparisons;
+        run.totalAssign += result.assignments;
+        run.times.insert(run.times.end(), result.times.begin(), result.times.end());
+        saveCell(sink, run.key->name, n, d, result);
+        if (cell % keys == keys - 1) cout << "." << flush;
+        if (cell % perSize != perSize - 1) return;
+
+        // Last cell of this size
+        fSummary << n << fixed << setprecision(2);
+        for (const KeyRun& r : runs) fSummary << "," << (double)r.totalComp / cfg.datasets;
+        for (const KeyRun& r : runs) fSummary << "," << (double)r.totalAssign / cfg.datasets;
+        for (const KeyRun& r : runs) timing::writeStats(fSummary, timing::summarize(r.times));
+        fSummary << "\n";
+
+        cout << " Avg:";
+        for (size_t i = 0; i < keys; i++)
+            cout << (i ? ", " : " ") << runs[i].key->label << "=" << (double)runs[i].totalComp / cfg.datasets;
+        cout << "\n";
+        for (KeyRun& r : runs) {
+            r.totalComp = r.totalAssign = 0;
+            r.times.clear();
+        }
+    };
+
+    cout << "\nMerge Sort Performance Analysis (Name-Age Records)\n";
+    cout << "===================================================\n";
+    cout << "Algorithm: " << cfg.algorithm << ", shape: " << gen::name(cfg.shape) << ", seed: " << cfg.seed
+         << ", threads: " << cfg.threads << "\n\n";
+
+    sweep::runOrdered(cfg.threads, sizes.size() * perSize, runCell, emit);
+
+    if (!sink.finish()) {
+        cout << "\nError: Could not write " << dir << "results.jsonl\n";
+        return false;
     }
-    
-    cout << "\nResults saved to ../results/\n";
-    cout << "Sorted data saved to ../results/sorted_*.csv\n";
-    cout << "Datasets saved to ../data/\n";
+    for (KeyRun& run : runs)
+        if (!closeOutput(run.comps, dir + run.key->file + ".csv") ||
+            !closeOutput(run.assigns, dir + run.key->file + "_assignments.csv"))
+            return false;
+    if (!closeOutput(fSummary, dir + "summary.csv")) return false;
+    if (unwritten) {
+        cout << "\nError: Could not write " << firstUnwritten << " and " << unwritten - 1 << " other --dumps files\n";
+        return false;
+    }
+    cout << "\nResults saved to " << dir << "\n";
+    cout << sink.cells() << " cells" << (payloadMode ? " with sorted rows" : "") << " saved to " << dir
+         << "results.jsonl\n";
+    if (dumpDatasets) {
+        cout << "Sorted data saved to " << dir << "sorted_*.csv\n";
+        cout << "Datasets saved to " << dataDir << "\n";
+    }
+    return true;
 }
 
 // ============================================================================
 // OPTION 2: Bank Customer Data Sorting by Salary
 // ============================================================================
 
-/**
- * @struct Customer
- * @brief Represents a bank customer with various attributes.
- */
-struct Customer {
-    string id, score, country, gender, age, tenure, balance, products, card, active, churn;
-    double salary;
-};
+/// Bank customers use the compact typed record from common/customer.hpp.
+using bank::Customer;
+
+/// Sort key for the bank data (sorted uncounted with sorting::NoCount).
+using BySalary = sorting::Key<sorting::Field<&Customer::salary>>;
+
+/// Capture hardware counters around each bank sort (set with --perf).
+bool perfMode = false;
+/// Sort (salary, row) pairs instead of whole records (set with --index).
+bool indexMode = false;
+/// Sort salaries with the LSD radix sort instead (set with --radix).
+bool radixMode = false;
+/// Sort salaries with the adaptive run-detecting merge sort instead (set with --adaptive).
+bool adaptiveMode = false;
+/// Memory budget in MB for the external sort of option 2; 0 sorts in memory (--external MB).
+long long externalMb = 0;
+/// Spill directory for the external sort; empty uses the system one (--spill-dir DIR).
+string spillDir;
+/// Bank CSV read by option 2 (--input PATH).
+string bankInput = "../bank_dataset.csv";
+/// Load the bank CSV from its binary snapshot when up to date (--no-snapshot disables).
+bool useSnapshot = true;
+/// Hand full output buffers of option 2 to a writer thread (set with --async-write).
+bool asyncWrite = false;
+/// Worker threads for CSV parsing and bank sorts (set with --threads).
+unsigned threadCount = 1;
+/// Ranges of at most this many rows are insertion sorted in the bank merge sort (--cutoff).
+std::ptrdiff_t insertionCutoff = 1;
 
 /**
- * @brief Loads bank customer data from a CSV file.
+ * @brief Loads bank customer data from a CSV file (or its up-to-date snapshot).
  * @param filename The path to the CSV file.
  * @return A vector of Customer objects.
  */
 vector<Customer> loadBankData(string filename) {
     vector<Customer> data;
-    ifstream file(filename);
-    string line, item;
+    csv::LoadStats stats;
 
-    if (!file.is_open()) {
+    bank::LoadSource source = bank::LoadSource::Csv;
+    bool ok = useSnapshot ? bank::loadCached(filename, data, &stats, threadCount, &source)
+                          : bank::loadCsv(filename, data, &stats, threadCount);
+    if (!ok) {
         cout << "Error: Could not open file " << filename << endl;
         return data;
     }
 
-    getline(file, line); // Skip header
-    while (getline(file, line)) {
-        stringstream ss(line);
-        vector<string> row;
-        while (getline(ss, item, ',')) row.push_back(item);
-
-        if (row.size() >= 12) {
-            Customer c;
-            c.id = row[0]; c.score = row[1]; c.country = row[2];
-            c.gender = row[3]; c.age = row[4]; c.tenure = row[5];
-            c.balance = row[6]; c.products = row[7]; c.card = row[8];
-            c.active = row[9];
-            try { c.salary = stod(row[10]); } catch (...) { c.salary = 0.0; }
-            c.churn = row[11];
-            data.push_back(c);
-        }
-    }
+    csv::report(cout, stats, source == bank::LoadSource::Snapshot ? "Loaded snapshot of" : "Parsed");
     return data;
 }
 
+/// @brief Algorithm name for the perf CSVs of options 2 and 3.
+string bankAlgorithm() {
+    string name = radixMode ? "radix_sort" : adaptiveMode ? "timsort" : "merge_sort";
+    return indexMode ? name + "_index" : name;
+}
+
 /**
- * @brief Merges two subarrays of Customers, sorted by salary.
- * @param data The vector of Customers.
- * @param left The starting index of the first subarray.
- * @param mid The ending index of the first subarray.
- * @param right The ending index of the second subarray.
+ * @brief Sorts bank rows by salary and writes them, with the header, to `out`.
+ * @details Whole-record mode sorts `customers` in place. Index mode sorts compact
+ * (salary, row) pairs instead and streams the rows through that permutation once
+ * while writing, so no reordered copy of the table is materialised. With --radix
+ * either mode uses the LSD radix sort on the salary bits instead of comparisons;
+ * with --adaptive, the run-detecting merge sort (same stable order).
+ * Nothing is written until the sort is done, so `out` times only the output.
+ * @param counters If non-null, hardware counters are captured around the sort.
+ * @param threads Threads for the whole-record comparison sort (1 sorts serially).
+ * @return The counter reading (all NA when `counters` is null).
  */
-void mergeBySalary(vector<Customer>& data, int left, int mid, int right) {
-    vector<Customer> temp(right - left + 1);
-    int i = left, j = mid + 1, k = 0;
+perf::Sample sortAndWriteBySalary(vector<Customer>& customers, csv::Writer& out, perf::CounterGroup* counters,
+                                  unsigned threads) {
+    perf::Sample sample;
+    auto run = [&](auto sortFn) {
+        if (counters) sample = perf::measure(*counters, sortFn);
+        else sortFn();
+    };
 
-    while (i <= mid && j <= right) {
-        if (data[i].salary <= data[j].salary) {
-            temp[k++] = data[i++];
+    if (indexMode) {
+        auto order = sorting::makeIndex(customers, sorting::Field<&Customer::salary>());
+        if (radixMode) run([&] { sorting::radixSort(order, sorting::ByKeyed<double>()); });
+        else if (adaptiveMode) run([&] { sorting::timSort(order, sorting::ByKeyed<double>()); });
+        else run([&] { sorting::mergeSortHybrid(order, sorting::ByKeyed<double>(), insertionCutoff); });
+        out.put(bank::HEADER).put('\n');
+        sorting::forEachInOrder(customers, order, [&](const Customer& c) { bank::writeLine(out, c); });
+    } else {
+        if (radixMode) {
+            run([&] { sorting::radixSort(customers, BySalary()); });
+        } else if (adaptiveMode) {
+            run([&] { sorting::timSort(customers, BySalary()); });
+        } else if (threads > 1) {
+            parallel::ThreadPool pool(threads);
+            run([&] { parallel::parallelMergeSort(customers, BySalary(), pool); });
         } else {
-            temp[k++] = data[j++];
+            run([&] { sorting::mergeSortHybrid(customers, BySalary(), insertionCutoff); });
         }
+        out.put(bank::HEADER).put('\n');
+        for (const auto& c : customers)
+            bank::writeLine(out, c);
     }
-
-    while (i <= mid) temp[k++] = data[i++];
-    while (j <= right) temp[k++] = data[j++];
-
-    for (int l = 0; l < temp.size(); l++) {
-        data[left + l] = temp[l];
-    }
+    return sample;
 }
 
 /**
- * @brief Sorts a vector of Customers by salary using merge sort.
- * @param data The vector of Customers to sort.
- * @param left The starting index of the array to be sorted.
- * @param right The ending index of the array to be sorted.
+ * @brief Sorts the bank CSV at `input` by salary with the external merge sort.
+ * @details Never holds more than the --external budget of rows; the output is
+ * the same as the in-memory stable sort. Run counts, bytes spilled and peak RSS
+ * are printed and saved to `../results/external_sort.csv`.
  */
-void mergeSortBySalary(vector<Customer>& data, int left, int right) {
-    if (left < right) {
-        int mid = left + (right - left) / 2;
-        mergeSortBySalary(data, left, mid);
-        mergeSortBySalary(data, mid + 1, right);
-        mergeBySalary(data, left, mid, right);
+bool externalBankSorting(const string& input) {
+    external::Config config;
+    config.memoryBytes = (size_t)externalMb << 20;
+    config.spillDir = spillDir;
+    external::Stats stats;
+
+    cout << "\nExternal Bank Customer Data Sorting\n";
+    cout << "===================================\n";
+    cout << "Sorting " << input << " by Estimated Salary within " << externalMb << " MB...\n";
+    if (!external::sortBankCsv(input, "../results/sorted_bank_dataset.csv", config, &stats)) {
+        cout << "\nError: external sort of " << input << " failed (input, output or spill files)\n";
+        return false;
     }
+
+    ofstream out("../results/external_sort.csv");
+    out << "rows,memory_mb,runs,merge_passes,fan_in,bytes_read,bytes_spilled,bytes_written,peak_rss_kb,seconds\n";
+    out << stats.rows << "," << externalMb << "," << stats.runs << "," << stats.mergePasses << "," << stats.fanIn
+        << "," << stats.bytesRead << "," << stats.bytesSpilled << "," << stats.bytesWritten << ","
+        << stats.peakRssKb << "," << stats.seconds << "\n";
+    if (!closeOutput(out, "../results/external_sort.csv")) return false;
+
+    if (stats.skipped) cout << "Skipped " << stats.skipped << " malformed or unrecognised rows\n";
+    cout << "Rows: " << stats.rows << ", runs: " << stats.runs << ", extra merge passes: " << stats.mergePasses
+         << "\nSpilled " << fixed << setprecision(2) << stats.bytesSpilled / 1e6 << " MB, peak RSS "
+         << stats.peakRssKb / 1024.0 << " MB, " << stats.seconds << " s\n";
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    cout << "Success! Sorted data saved to ../results/sorted_bank_dataset.csv\n";
+    return true;
 }
 
 /**
  * @brief Loads bank customer data, sorts it by salary, and saves the result.
- * @details Reads data from `../bank_dataset.csv`, sorts it, and writes the sorted data
- * to `../results/sorted_bank_dataset.csv`.
+ * @details Reads data from `../bank_dataset.csv` (or --input), sorts it, and writes
+ * the sorted data to `../results/sorted_bank_dataset.csv`. With --external the
+ * file is sorted out of core instead (externalBankSorting).
  */
-void bankCustomerSorting() {
-    string input = "../bank_dataset.csv";
+bool bankCustomerSorting() {
+    string input = bankInput;
+    if (externalMb > 0) return externalBankSorting(input);
     vector<Customer> customers = loadBankData(input);
 
     if (customers.empty()) {
         cout << "\nError: Could not load bank customer data from " << input << endl;
-        return;
+        return false;
     }
 
     cout << "\nBank Customer Data Sorting\n";
     cout << "===========================\n";
     cout << "Sorting " << customers.size() << " records by Estimated Salary...\n";
     
-    mergeSortBySalary(customers, 0, customers.size() - 1);
-
-    ofstream fout("../results/sorted_bank_dataset.csv");
-    fout << "customer_id,credit_score,country,gender,age,tenure,balance,products_number,credit_card,active_member,estimated_salary,churn\n";
-    
-    for (const auto& c : customers) {
-        fout << c.id << "," << c.score << "," << c.country << "," << c.gender << ","
-             << c.age << "," << c.tenure << "," << c.balance << "," << c.products << ","
-             << c.card << "," << c.active << "," << fixed << setprecision(2) << c.salary << ","
-             << c.churn << "\n";
+    csv::Writer fout("../results/sorted_bank_dataset.csv", csv::WRITE_BUFFER_BYTES, asyncWrite);
+    if (perfMode) {
+        perf::CounterGroup counters;
+        perf::Sample sample = sortAndWriteBySalary(customers, fout, &counters, threadCount);
+        ofstream fperf("../results/bank_perf.csv");
+        fperf << "algorithm,rows," << perf::header() << "\n";
+        fperf << bankAlgorithm() << "," << customers.size() << ",";
+        perf::writeSample(fperf, sample);
+        fperf << "\n";
+        if (!closeOutput(fperf, "../results/bank_perf.csv")) return false;
+        cout << (counters.available() ? "Hardware counters saved to ../results/bank_perf.csv\n"
+                                      : "Hardware counters unavailable; NA written to ../results/bank_perf.csv\n");
+    } else {
+        sortAndWriteBySalary(customers, fout, nullptr, threadCount);
+    }
+    if (!fout.finish()) {
+        cout << "Error: Could not write ../results/sorted_bank_dataset.csv\n";
+        return false;
     }
 
+    csv::report(cout, fout.stats(customers.size()), "Wrote");
     cout << "Success! Sorted data saved to ../results/sorted_bank_dataset.csv\n";
-    
+    return true;
 }
 
 // ============================================================================
@@ -467,84 +541,378 @@ void bankCustomerSorting() {
  * @param allCustomers The vector of all customers.
  * @param n The number of records to sample.
  * @param rng The random number generator.
+ * @param shape Input distribution (common/generators.hpp); sorted-like shapes are ordered by salary.
  * @return A vector of sampled Customer records.
  */
-vector<Customer> sampleBankData(const vector<Customer>& allCustomers, int n, mt19937& rng) {
-    vector<Customer> sampledData;
-    if (allCustomers.empty() || n == 0) {
-        return sampledData;
-    }
-    
-    uniform_int_distribution<size_t> dist(0, allCustomers.size() - 1);
-    
-    for (int i = 0; i < n; ++i) {
-        sampledData.push_back(allCustomers[dist(rng)]);
-    }
-    
-    return sampledData;
+vector<Customer> sampleBankData(const vector<Customer>& allCustomers, long long n, mt19937& rng,
+                                gen::Shape shape = gen::Shape::Uniform) {
+    if (allCustomers.empty()) return {};
+    auto drawCustomer = [&](gen::Picker& pick) { return allCustomers[pick(allCustomers.size())]; };
+    return gen::generate<Customer>(shape, n, rng, drawCustomer, BySalary());
 }
 
 /**
  * @brief Runs sorting on sampled bank customer data.
  * @details Loads the full bank dataset, then for various sizes `n`, it creates
- * multiple sampled datasets, sorts them by salary, and saves the results.
+ * multiple sampled datasets, sorts them by salary, and saves the results. Sizes,
+ * datasets, seed, shape and --threads are option 1's sweep settings; each (n, dataset)
+ * sample is drawn from its own generator (sweep::cellRng).
  */
-void bankCustomerSamplingSorting() {
+bool bankCustomerSamplingSorting() {
     string main_dataset_path = "../bank_dataset.csv";
     vector<Customer> allCustomers = loadBankData(main_dataset_path);
 
     if (allCustomers.empty()) {
         cout << "\nError: Could not load main bank customer data from " << main_dataset_path << endl;
-        return;
+        return false;
     }
 
-    mt19937 rng(time(nullptr));
-    const int DATASETS = 10;
+    const sweep::Config& cfg = sweepConfig;
+
+    // With --perf, one row of hardware counters per sampled sort
+    ofstream fperf;
+    if (perfMode) {
+        fperf.open("../results/bank_sampled_perf.csv");
+        fperf << "algorithm,shape,n,dataset," << perf::header() << "\n";
+    }
 
     cout << "\nBank Customer Data Sorting (with Sampling)\n";
-    cout << "===========================================\n\n";
-
-    for (int n = 10; n <= 100; n += 10) {
-        cout << "n = " << setw(3) << n << ": ";
-        for (int d = 0; d < DATASETS; d++) {
-            // Sample data
-            vector<Customer> sampledData = sampleBankData(allCustomers, n, rng);
-
-            // Save unsorted sample
-            string unsorted_filename = "../data/bank_sampled_n" + to_string(n) + "_d" + to_string(d+1) + ".csv";
-            ofstream funsorted(unsorted_filename);
-            funsorted << "customer_id,credit_score,country,gender,age,tenure,balance,products_number,credit_card,active_member,estimated_salary,churn\n";
-            for (const auto& c : sampledData) {
-                funsorted << c.id << "," << c.score << "," << c.country << "," << c.gender << ","
-                         << c.age << "," << c.tenure << "," << c.balance << "," << c.products << ","
-                         << c.card << "," << c.active << "," << fixed << setprecision(2) << c.salary << ","
-                         << c.churn << "\n";
-            }
-            funsorted.close();
-
-            // Sort the sampled data
-            mergeSortBySalary(sampledData, 0, sampledData.size() - 1);
-
-            // Save sorted sample
-            string sorted_filename = "../results/sorted_bank_sampled_n" + to_string(n) + "_d" + to_string(d+1) + ".csv";
-            ofstream fsorted(sorted_filename);
-            fsorted << "customer_id,credit_score,country,gender,age,tenure,balance,products_number,credit_card,active_member,estimated_salary,churn\n";
-            for (const auto& c : sampledData) {
-                fsorted << c.id << "," << c.score << "," << c.country << "," << c.gender << ","
-                       << c.age << "," << c.tenure << "," << c.balance << "," << c.products << ","
-                       << c.card << "," << c.active << "," << fixed << setprecision(2) << c.salary << ","
-                       << c.churn << "\n";
-            }
-            fsorted.close();
+    cout << "===========================================\n";
+    cout << "Shape: " << gen::name(cfg.shape) << ", seed: " << cfg.seed << ", threads: " << cfg.threads << "\n\n";
+
+    // Cells are (n, dataset) pairs in loop order; each samples with its own generator and
+    // returns its counters and the first of its two files that could not be written, if any
+    struct SampleCell {
+        perf::Sample sample;
+        string unwritten;
+    };
+    const vector<long long> sizes = cfg.sizes.values();
+    const size_t datasets = cfg.datasets;
+
+    // Runs on a pool thread: writes only this cell's two files
+    auto runCell = [&](size_t cell) {
+        const long long n = sizes[cell / datasets];
+        const int d = (int)(cell % datasets) + 1;
+        mt19937 rng = sweep::cellRng(cfg.seed, n, d);
+        vector<Customer> sampledData = sampleBankData(allCustomers, n, rng, cfg.shape);
 
-            cout << ".";
+        // Save unsorted sample
+        string unsorted_filename = "../data/bank_sampled_n" + to_string(n) + "_d" + to_string(d) + ".csv";
+        csv::Writer funsorted(unsorted_filename, 64 << 10);
+        funsorted.put(bank::HEADER).put('\n');
+        for (const auto& c : sampledData)
+            bank::writeLine(funsorted, c);
+        if (!funsorted.finish()) return SampleCell{perf::Sample(), unsorted_filename};
+
+        // Sort the sampled data and save the sorted sample; counters are opened on the sorting thread
+        unique_ptr<perf::CounterGroup> counters;
+        if (perfMode) counters.reset(new perf::CounterGroup());
+        string sorted_filename = "../results/sorted_bank_sampled_n" + to_string(n) + "_d" + to_string(d) + ".csv";
+        csv::Writer fsorted(sorted_filename, 64 << 10);
+        perf::Sample sample = sortAndWriteBySalary(sampledData, fsorted, counters.get(), 1);
+        return SampleCell{sample, fsorted.finish() ? string() : sorted_filename};
+    };
+
+    // Runs on this thread, in cell order
+    size_t unwritten = 0;
+    string firstUnwritten;
+    auto emit = [&](size_t cell, const SampleCell& result) {
+        const long long n = sizes[cell / datasets];
+        const int d = (int)(cell % datasets) + 1;
+        const perf::Sample& sample = result.sample;
+        if (!result.unwritten.empty() && unwritten++ == 0) firstUnwritten = result.unwritten;
+        if (d == 1) cout << "n = " << setw(3) << n << ": " << flush;
+        if (perfMode) {
+            fperf << bankAlgorithm() << "," << gen::name(cfg.shape) << "," << n << "," << d << ",";
+            perf::writeSample(fperf, sample);
+            fperf << "\n";
         }
-        cout << " Done.\n";
-    }
+        cout << "." << flush;
+        if ((size_t)d == datasets) cout << " Done.\n";
+    };
 
+    sweep::runOrdered(cfg.threads, sizes.size() * datasets, runCell, emit);
+
+    if (unwritten) {
+        cout << "\nError: Could not write " << firstUnwritten << "; " << unwritten << " of "
+             << sizes.size() * datasets << " samples failed\n";
+        return false;
+    }
+    if (perfMode && !closeOutput(fperf, "../results/bank_sampled_perf.csv")) return false;
     cout << "\nSuccess! Sampled, sorted data saved to ../results/ and ../data/ directories.\n";
+    return true;
+}
+
+
+// ============================================================================
+// OPTION 4: Parallel Merge Sort Scaling
+// ============================================================================
+
+/**
+ * @brief Times serial and parallel merge sort of one input for each thread count.
+ * @details Each cell is the median of 3 runs after 1 warm-up. Speedup is relative
+ * to the parallel sort on 1 thread; `stable` checks the output is identical to the
+ * serial (stable) merge sort, which the name-then-age ordering relies on.
+ * @param same Full-record equality used for that check.
+ */
+template <class T, class K, class Same>
+void scaleMergeSort(ofstream& out, const string& label, const vector<T>& input, const K& key,
+                    Same same, const vector<unsigned>& threadCounts) {
+    timing::Config cfg;
+    cfg.warmup = 1;
+    cfg.repetitions = 3;
+
+    vector<T> expected = input;
+    sorting::mergeSort(expected, key);
+    vector<double> serial;
+    timing::sample(input, [&](vector<T>& v) { sorting::mergeSort(v, key); }, cfg, serial);
+    double serialMs = timing::summarize(serial).median / 1e6;
+    out << label << "," << input.size() << ",serial,1," << serialMs << ",,1\n";
+    cout << "  " << left << setw(16) << label << " serial      " << right << setw(10) << serialMs << " ms\n";
+
+    double baseMs = 0;
+    for (unsigned t : threadCounts) {
+        parallel::ThreadPool pool(t);
+        vector<double> samples;
+        timing::sample(input, [&](vector<T>& v) { parallel::parallelMergeSort(v, key, pool); }, cfg, samples);
+        double ms = timing::summarize(samples).median / 1e6;
+        if (t == threadCounts.front()) baseMs = ms;
+
+        vector<T> check = input;
+        parallel::parallelMergeSort(check, key, pool);
+        bool stable = equal(check.begin(), check.end(), expected.begin(), same);
+        out << label << "," << input.size() << ",parallel," << t << "," << ms << ","
+            << baseMs / ms << "," << stable << "\n";
+        cout << "  " << left << setw(16) << label << " " << setw(2) << t << " threads  " << right
+             << setw(10) << ms << " ms  speedup " << baseMs / ms << (stable ? "" : "  ORDER MISMATCH") << "\n";
+    }
+}
+
+/**
+ * @brief Reports parallel merge sort speedup against thread count.
+ * @details Sorts the bank data by salary and 1,000,000 generated Name-Age records by
+ * age, name and name-then-age with 1, 2, 4, ... threads (up to --threads or the
+ * hardware thread count) and writes `../results/parallel_speedup.csv`.
+ */
+bool parallelMergeSortScaling() {
+    unsigned maxThreads = max(threadCount, thread::hardware_concurrency());
+    vector<unsigned> threadCounts;
+    for (unsigned t = 1; t < maxThreads; t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(maxThreads);
+
+    vector<Customer> customers = loadBankData("../bank_dataset.csv");
+    mt19937 rng(time(nullptr));
+    vector<Record> records = generateData(1000000, rng);
+
+    ofstream out("../results/parallel_speedup.csv");
+    out << "key,n,variant,threads,median_ms,speedup,stable\n";
+    out << fixed << setprecision(3);
+    cout << fixed << setprecision(3);
+
+    cout << "\nParallel Merge Sort Scaling\n";
+    cout << "===========================\n";
+    auto sameCustomer = [](const Customer& a, const Customer& b) { return a.id == b.id; };
+    auto sameRecord = [](const Record& a, const Record& b) { return a.name == b.name && a.age == b.age; };
+    if (!customers.empty())
+        scaleMergeSort(out, "bank_salary", customers, BySalary(), sameCustomer, threadCounts);
+    scaleMergeSort(out, "record_age", records, ByAge(), sameRecord, threadCounts);
+    scaleMergeSort(out, "record_name", records, ByName(), sameRecord, threadCounts);
+    scaleMergeSort(out, "record_name_age", records, ByNameThenAge(), sameRecord, threadCounts);
+
+    cout.unsetf(ios::fixed);
+    if (!closeOutput(out, "../results/parallel_speedup.csv")) return false;
+    cout << "\nResults saved to ../results/parallel_speedup.csv\n";
+    return true;
+}
+
+// ============================================================================
+// OPTION 5: Merge Sort Buffer Modes
+// ============================================================================
+
+/**
+ * @brief Counts and times one input under every merge sort buffer mode.
+ * @details Modes: `per_merge` (original, one temporary per merge call),
+ * `single_buffer` (one buffer per sort, ping-pong), `bottom_up` (iterative, one
+ * buffer per sort) and `arena` (single buffer owned by the caller and already large
+ * enough, so the sort itself allocates nothing). Comparisons, assignments and allocations come from one
+ * counted run; median_ns is over uncounted runs. `same` checks each mode against
+ * the per-merge result.
+ */
+template <class T, class K, class Same>
+void compareBufferModes(ofstream& out, const string& label, const vector<T>& input, const K& key, Same same) {
+    timing::Config cfg;
+    cfg.warmup = 1;
+    cfg.repetitions = 5;
+
+    vector<T> expected = input;
+    sorting::mergeSort(expected, key);
+    vector<T> arena;
+    arena.reserve(input.size()); // caller-owned buffer already grown by an earlier sort
+
+    auto report = [&](const string& mode, auto sortFn) {
+        long long allocations = 0;
+        sorting::CountOps counted{&comparisons, &assignments, &allocations};
+        comparisons = 0;
+        assignments = 0;
+        vector<T> data = input;
+        sortFn(data, counted);
+        bool ok = equal(data.begin(), data.end(), expected.begin(), same);
+
+        vector<double> times;
+        timing::sample(input, [&](vector<T>& v) { sortFn(v, sorting::NoCount()); }, cfg, times);
+        double median = timing::summarize(times).median;
+
+        out << label << "," << input.size() << "," << mode << "," << comparisons << "," << assignments << ","
+            << allocations << "," << median << "," << ok << "\n";
+        cout << "  " << left << setw(16) << label << setw(8) << input.size() << setw(14) << mode << right
+             << " allocs " << setw(8) << allocations << "  median " << setw(12) << median << " ns"
+             << (ok ? "" : "  ORDER MISMATCH") << "\n";
+    };
+
+    report("per_merge", [&](vector<T>& v, const auto& p) { sorting::mergeSort(v, key, p); });
+    report("single_buffer", [&](vector<T>& v, const auto& p) { sorting::mergeSortBuffered(v, key, p); });
+    report("bottom_up", [&](vector<T>& v, const auto& p) { sorting::mergeSortBottomUp(v, key, p); });
+    report("arena", [&](vector<T>& v, const auto& p) { sorting::mergeSortBuffered(v, key, p, &arena); });
+}
+
+/**
+ * @brief Compares allocation counts and latency of the merge sort buffer modes.
+ * @details Uses generated Name-Age records of 100 to 100,000 rows (by age, name and
+ * name-then-age) and the bank data by salary; writes `../results/merge_buffer_modes.csv`.
+ */
+bool mergeBufferModes() {
+    mt19937 rng(time(nullptr));
+    vector<Customer> customers = loadBankData("../bank_dataset.csv");
+
+    ofstream out("../results/merge_buffer_modes.csv");
+    out << "key,n,mode,comparisons,assignments,allocations,median_ns,matches\n";
+    out << fixed << setprecision(0);
+    cout << fixed << setprecision(0);
+
+    cout << "\nMerge Sort Buffer Modes\n";
+    cout << "=======================\n";
+    auto sameCustomer = [](const Customer& a, const Customer& b) { return a.id == b.id; };
+    auto sameRecord = [](const Record& a, const Record& b) { return a.name == b.name && a.age == b.age; };
+    for (int n : {100, 1000, 10000, 100000}) {
+        vector<Record> records = generateData(n, rng);
+        compareBufferModes(out, "record_age", records, ByAge(), sameRecord);
+        compareBufferModes(out, "record_name", records, ByName(), sameRecord);
+        compareBufferModes(out, "record_name_age", records, ByNameThenAge(), sameRecord);
+    }
+    if (!customers.empty())
+        compareBufferModes(out, "bank_salary", customers, BySalary(), sameCustomer);
+
+    cout.unsetf(ios::fixed);
+    if (!closeOutput(out, "../results/merge_buffer_modes.csv")) return false;
+    cout << "\nResults saved to ../results/merge_buffer_modes.csv\n";
+    return true;
+}
+
+// ============================================================================
+// OPTION 6: Adaptive Merge Sort on Presorted Data
+// ============================================================================
+
+/**
+ * @brief Presorted variants of `input`: its own order, then arranged as sorted, 1% swapped,
+ * 1% appended, sawtooth, organ pipe and reversed (common/generators.hpp).
+ * @details `appended` models a daily extract: the table sorted by yesterday's run
+ * with 1% of its rows taken out and re-appended at the end in arbitrary order.
+ */
+template <class T, class K>
+vector<pair<string, vector<T>>> presortedShapes(const vector<T>& input, const K& key, mt19937& rng) {
+    vector<pair<string, vector<T>>> shapes{{"random", input}};
+    for (gen::Shape shape : {gen::Shape::Sorted, gen::Shape::NearlySorted, gen::Shape::Appended,
+                             gen::Shape::Sawtooth, gen::Shape::OrganPipe, gen::Shape::Reversed}) {
+        vector<T> data = input;
+        gen::arrange(data, shape, key, rng);
+        shapes.emplace_back(gen::name(shape), move(data));
+    }
+    return shapes;
 }
 
+/**
+ * @brief Counts and times merge sort and the adaptive merge sort on one input.
+ * @details Comparisons, assignments and runs come from one counted run; median_ns
+ * is over uncounted runs. Runs are the natural runs the adaptive sort found (NA
+ * for merge sort). `same` checks the order against the stable merge sort.
+ */
+template <class T, class K, class Same>
+void compareAdaptive(ofstream& out, const string& label, const string& shape, const vector<T>& input,
+                     const K& key, Same same) {
+    timing::Config cfg;
+    cfg.warmup = 1;
+    cfg.repetitions = 5;
+
+    vector<T> expected = input;
+    sorting::mergeSortBuffered(expected, key);
+
+    auto report = [&](const string& algorithm, auto sortFn) {
+        sorting::TimSortStats stats;
+        sorting::CountOps counted{&comparisons, &assignments};
+        comparisons = 0;
+        assignments = 0;
+        vector<T> data = input;
+        bool adaptive = sortFn(data, counted, &stats);
+        bool ok = equal(data.begin(), data.end(), expected.begin(), same);
+
+        vector<double> times;
+        timing::sample(input, [&](vector<T>& v) { sortFn(v, sorting::NoCount(), nullptr); }, cfg, times);
+        double median = timing::summarize(times).median;
+
+        out << label << "," << shape << "," << input.size() << "," << algorithm << ",";
+        if (adaptive) out << stats.runs;
+        else out << "NA";
+        out << "," << comparisons << "," << assignments << "," << median << "," << ok << "\n";
+        cout << "  " << left << setw(16) << label << setw(15) << shape << setw(11) << algorithm << right
+             << " cmp/n " << setw(6) << setprecision(2) << (double)comparisons / input.size()
+             << "  runs " << setw(7) << (adaptive ? to_string(stats.runs) : string("NA"))
+             << "  median " << setw(12) << setprecision(0) << median << " ns" << (ok ? "" : "  ORDER MISMATCH") << "\n";
+    };
+
+    report("merge_sort", [&](vector<T>& v, const auto& p, sorting::TimSortStats*) {
+        sorting::mergeSortBuffered(v, key, p);
+        return false;
+    });
+    report("timsort", [&](vector<T>& v, const auto& p, sorting::TimSortStats* stats) {
+        sorting::timSort(v, key, p, stats);
+        return true;
+    });
+}
+
+/**
+ * @brief Compares merge sort with the adaptive merge sort on presorted inputs.
+ * @details Bank data by salary and generated Name-Age records (100,000 and
+ * 1,000,000 rows, by name then age) in every shape from presortedShapes;
+ * writes `../results/adaptive_sort.csv`.
+ */
+bool adaptiveMergeSort() {
+    mt19937 rng(time(nullptr));
+    vector<Customer> customers = loadBankData("../bank_dataset.csv");
+
+    ofstream out("../results/adaptive_sort.csv");
+    out << "key,shape,n,algorithm,runs,comparisons,assignments,median_ns,matches\n";
+    out << fixed << setprecision(0);
+    cout << fixed;
+
+    cout << "\nAdaptive Merge Sort on Presorted Data\n";
+    cout << "=====================================\n";
+    auto sameCustomer = [](const Customer& a, const Customer& b) { return a.id == b.id; };
+    auto sameRecord = [](const Record& a, const Record& b) { return a.name == b.name && a.age == b.age; };
+    if (!customers.empty())
+        for (const auto& shape : presortedShapes(customers, BySalary(), rng))
+            compareAdaptive(out, "bank_salary", shape.first, shape.second, BySalary(), sameCustomer);
+    for (int n : {100000, 1000000}) {
+        vector<Record> records = generateData(n, rng);
+        for (const auto& shape : presortedShapes(records, ByNameThenAge(), rng))
+            compareAdaptive(out, "record_name_age", shape.first, shape.second, ByNameThenAge(), sameRecord);
+    }
+
+    cout.unsetf(ios::fixed);
+    cout << setprecision(6);
+    if (!closeOutput(out, "../results/adaptive_sort.csv")) return false;
+    cout << "\nResults saved to ../results/adaptive_sort.csv\n";
+    return true;
+}
 
 // ============================================================================
 // MAIN MENU
@@ -565,18 +933,129 @@ void displayMenu() {
     cout << "\n";
     cout << "  3. Bank Customer Data Sorting with Sampling\n";
     cout << "\n";
-    cout << "  4. Exit\n";
+    cout << "  4. Parallel Merge Sort Scaling (speedup vs thread count)\n";
+    cout << "\n";
+    cout << "  5. Merge Sort Buffer Modes (allocations: per-merge vs single buffer vs bottom-up)\n";
+    cout << "\n";
+    cout << "  6. Adaptive Merge Sort on Presorted Data (natural runs, galloping merges)\n";
+    cout << "\n";
+    cout << "  7. Exit\n";
     cout << "\n";
     cout << "----------------------------------------------------------\n";
-    cout << "Enter your choice (1-4): ";
+    cout << "Enter your choice (1-7): ";
+}
+
+/**
+ * @brief Runs menu option `choice` (1-6).
+ * @return 0 if the option succeeded, 1 if it failed (it has said why), -1 if there is no such option.
+ */
+int runOption(int choice) {
+    switch (choice) {
+        case 1:
+            return nameAgePerformanceAnalysis() ? 0 : 1;
+        case 2:
+            return bankCustomerSorting() ? 0 : 1;
+        case 3:
+            return bankCustomerSamplingSorting() ? 0 : 1;
+        case 4:
+            return parallelMergeSortScaling() ? 0 : 1;
+        case 5:
+            return mergeBufferModes() ? 0 : 1;
+        case 6:
+            return adaptiveMergeSort() ? 0 : 1;
+        default:
+            return -1;
+    }
 }
 
 /**
- * @brief The main function of the program.
+ * @return 0 on success, 1 on a bad flag or if the `--run` option failed.
  * @return 0 on successful execution.
  */
-int main() {
+int main(int argc, char* argv[]) {
     int choice;
+
+    // Every argument must be one of the flags below, or the value of one
+    vector<string> options = {"--warmup", "--reps", "--cutoff", "--external", "--spill-dir", "--input", "--run"};
+    options.insert(options.end(), sweep::OPTIONS.begin(), sweep::OPTIONS.end());
+    string error;
+    if (!cli::checkFlags(argc, argv,
+                         {"--dumps", "--payloads", "--perf", "--index", "--radix", "--adaptive", "--no-snapshot",
+                          "--async-write"},
+                         options, error)) {
+        cout << "Error: " << error << "\n";
+        return 1;
+    }
+
+    // Timing mode for option 1: --warmup W --reps R
+    bool valid = cli::intValue(argc, argv, "--warmup", timingConfig.warmup, 0, 1000000, error) &&
+                 cli::intValue(argc, argv, "--reps", timingConfig.repetitions, 1, 1000000, error);
+    // Per-dataset CSVs and sorted rows in results.jsonl for option 1: --dumps, --payloads
+    dumpDatasets = cli::has(argc, argv, "--dumps");
+    payloadMode = cli::has(argc, argv, "--payloads");
+    // Hardware counters for options 2 and 3: --perf
+    perfMode = cli::has(argc, argv, "--perf");
+    // Index (permutation) sort mode for options 2 and 3: --index
+    indexMode = cli::has(argc, argv, "--index");
+    // LSD radix sort on salary bits for options 2 and 3: --radix
+    radixMode = cli::has(argc, argv, "--radix");
+    // Hybrid merge sort for options 2 and 3, insertion sort below N rows: --cutoff N
+    valid = valid && cli::intValue(argc, argv, "--cutoff", insertionCutoff, 1, 1 << 30, error);
+    // Adaptive run-detecting merge sort for options 2 and 3: --adaptive
+    adaptiveMode = cli::has(argc, argv, "--adaptive");
+    // External merge sort for option 2 within N MB: --external N [--spill-dir DIR] [--input PATH]
+    valid = valid && cli::intValue(argc, argv, "--external", externalMb, 0, 1 << 20, error);
+    if (const char* dir = cli::value(argc, argv, "--spill-dir")) spillDir = dir;
+    if (const char* path = cli::value(argc, argv, "--input")) bankInput = path;
+    // Always parse the bank CSV instead of loading <csv>.snap: --no-snapshot
+    useSnapshot = !cli::has(argc, argv, "--no-snapshot");
+    // Write the sorted bank CSV of option 2 on a background thread: --async-write
+    asyncWrite = cli::has(argc, argv, "--async-write");
+    // Parallel CSV parsing and bank sorts, sweep cells of options 1 and 3, max threads for option 4: --threads N
+    valid = valid && cli::intValue(argc, argv, "--threads", threadCount, 1, 1024, error);
+    // Run one menu option without the menu and exit: --run N
+    int option = 0;
+    valid = valid && cli::intValue(argc, argv, "--run", option, 1, 6, error);
+    if (!valid) {
+        cout << "Error: " << error << "\n";
+        return 1;
+    }
+    // --cutoff only reaches the serial hybrid merge sort: the radix sort and the adaptive merge
+    // sort have no insertion cutoff, and the parallel merge sort of option 2 has its own
+    if (cli::has(argc, argv, "--cutoff")) {
+        if (radixMode || adaptiveMode) {
+            cout << "Error: --cutoff sets the hybrid merge sort, which " << (radixMode ? "--radix" : "--adaptive")
+                 << " replaces\n";
+            return 1;
+        }
+        if (threadCount > 1 && !indexMode)
+            cout << "Warning: option 2 sorts with the parallel merge sort on --threads " << threadCount
+                 << ", which ignores --cutoff; option 3 and --index still use it\n";
+    }
+    // Sweep of option 1 (sizes, datasets and seed also drive option 3): --n FROM:TO:STEP|FROM:TO:xFACTOR
+    // --datasets D --seed S --key age,name,combined --algorithm NAME --shape NAME --out DIR (see common/sweep.hpp)
+    sweepConfig.keys = {"age", "name", "combined"};
+    sweepConfig.algorithm = "merge_sort";
+    if (!sweep::parse(argc, argv, sweepConfig, error)) {
+        cout << "Error: " << error << "\n";
+        return 1;
+    }
+    for (const string& key : sweepConfig.keys) {
+        if (!findRecordKey(key)) {
+            cout << "Error: unknown --key " << key << " (age, name or combined)\n";
+            return 1;
+        }
+    }
+    auto algorithm = find(RECORD_SORTS.begin(), RECORD_SORTS.end(), sweepConfig.algorithm);
+    if (algorithm == RECORD_SORTS.end()) {
+        cout << "Error: unknown --algorithm " << sweepConfig.algorithm
+             << " (merge_sort, merge_sort_buffered, merge_sort_bottom_up or timsort)\n";
+        return 1;
+    }
+    recordSort = (RecordSort)(algorithm - RECORD_SORTS.begin());
+
+    // --run 1, e.g. an unattended sweep
+    if (option) return runOption(option);
     
     while (true) {
         displayMenu();
@@ -585,31 +1064,15 @@ int main() {
         // Clear the input buffer
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-        switch (choice) {
-            case 1:
-                nameAgePerformanceAnalysis();
-                cout << "\nPress Enter to continue...";
-                cin.get();
-                break;
-                
-            case 2:
-                bankCustomerSorting();
-                cout << "\nPress Enter to continue...";
-                cin.get();
-                break;
-                
-            case 3:
-                bankCustomerSamplingSorting();
-                cout << "\nPress Enter to continue...";
-                cin.get();
-                break;
-
-            case 4:
-                cout << "\nExited!\n";
-                return 0;
-                
-            default:
-                cout << "\nInvalid choice! Please select 1-4.\n";
+        if (choice == 7) {
+            cout << "\nExited!\n";
+            return 0;
+        }
+        if (runOption(choice) >= 0) {
+            cout << "\nPress Enter to continue...";
+            cin.get();
+        } else {
+            cout << "\nInvalid choice! Please select 1-7.\n";
         }
     }
     
@@ -10,11 +10,17 @@
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
+#include <charconv>
+#include <string_view>
 #include <vector>
 #include <string>
 #include <iomanip>
 
+#include "../../common/cli.hpp"
+#include "../../common/csv_mmap.hpp"
+#include "../../common/result_sink.hpp"
+#include "../../common/sorting.hpp"
+
 using namespace std;
 
 struct Driver {
@@ -25,25 +31,33 @@ struct Driver {
 long long comparisons = 0;
 long long assignments = 0;
 
-/// @brief Load all data from CSV file
+using ByLapTime = sorting::Key<sorting::Field<&Driver::lapTime>>;
+const sorting::CountOps ops{&comparisons, &assignments};
+
+/// @brief Load all data from CSV file (memory-mapped, fields parsed in place)
 vector<Driver> loadAllData(const string& filename) {
     vector<Driver> allData;
-    ifstream file(filename);
-    string line;
+    csv::Stopwatch clock;
+    csv::MappedFile file(filename);
+    if (!file.ok()) return allData;
     
     // Skip header
-    getline(file, line);
-    
-    while (getline(file, line)) {
-        stringstream ss(line);
-        string name;
-        double lapTime;
-        
-        getline(ss, name, ',');
-        ss >> lapTime;
+    csv::forEachLine(csv::skipLine(file.view()), [&allData](string_view line) {
+        size_t comma = line.find(',');
+        if (comma == string_view::npos) return;
+        string_view time = line.substr(comma + 1);
+        while (!time.empty() && time.front() == ' ') time.remove_prefix(1);
         
-        allData.push_back({name, lapTime});
-    }
+        double lapTime = 0.0;
+        from_chars(time.data(), time.data() + time.size(), lapTime);
+        allData.push_back({string(line.substr(0, comma)), lapTime});
+    });
+    
+    csv::LoadStats stats;
+    stats.bytes = file.view().size();
+    stats.rows = allData.size();
+    stats.seconds = clock.seconds();
+    csv::report(cout, stats);
     
     return allData;
 }
@@ -61,24 +75,17 @@ vector<Driver> getData(const vector<Driver>& allData, int n, int datasetNum) {
     return data;
 }
 
-/// @brief Sort by lap time (ascending)
-void sortByLapTime(vector<Driver>& data) {
-    for (size_t i = 1; i < data.size(); i++) {
-        Driver key = data[i];
-        assignments++;
-        int j = i - 1;
-        while (j >= 0 && (comparisons++, data[j].lapTime > key.lapTime)) {
-            data[j + 1] = data[j];
-            assignments++;
-            j--;
-        }
-        data[j + 1] = key;
-        assignments++;
-    }
-}
-
-int main() {
+int main(int argc, char* argv[]) {
     const int DATASETS = 10;
+    // --dumps also writes every dataset and its sorted copy to its own CSV;
+    // --payloads stores the sorted rows of each cell in results.jsonl instead
+    string error;
+    if (!cli::checkFlags(argc, argv, {"--dumps", "--payloads"}, {}, error)) {
+        cout << "Error: " << error << "\n";
+        return 1;
+    }
+    bool dumpDatasets = cli::has(argc, argv, "--dumps");
+    bool payloadMode = cli::has(argc, argv, "--payloads");
     
     // Load all data from CSV
     vector<Driver> allData = loadAllData("../q1_data.csv");
@@ -87,6 +94,7 @@ int main() {
     ofstream fLapTime("../results/sort_by_laptime.csv");
     ofstream fLapTimeAssign("../results/sort_by_laptime_assignments.csv");
     ofstream fSummary("../results/summary.csv");
+    results::Sink sink("../results/results.jsonl", payloadMode);
     
     fLapTime << "n,dataset,comparisons\n";
     fLapTimeAssign << "n,dataset,assignments\n";
@@ -104,26 +112,36 @@ int main() {
             vector<Driver> original = getData(allData, n, d + 1);
             
             // Save dataset
-            ofstream fData("../data/qualifying_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            fData << "driver,q1\n";
-            for (auto& r : original)
-                fData << r.name << "," << fixed << setprecision(3) << r.lapTime << "\n";
+            if (dumpDatasets) {
+                ofstream fData("../data/qualifying_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
+                fData << "driver,q1\n";
+                for (auto& r : original)
+                    fData << r.name << "," << fixed << setprecision(3) << r.lapTime << "\n";
+            }
             
             // Sort by lap time
             vector<Driver> data = original;
             comparisons = 0;
             assignments = 0;
-            sortByLapTime(data);
+            sorting::insertionSort(data, ByLapTime(), ops);
             fLapTime << n << "," << d+1 << "," << comparisons << "\n";
             fLapTimeAssign << n << "," << d+1 << "," << assignments << "\n";
             totalComp += comparisons;
             totalAssign += assignments;
             
+            sink.begin({"insertion_sort", "laptime", n, d + 1})
+                .field("comparisons", comparisons)
+                .field("assignments", assignments)
+                .payload(data, [](results::Sink::Tuple& row, const Driver& r) { row.value(r.name).value(r.lapTime, 3); });
+            sink.end();
+            
             // Save sorted data
-            ofstream fSorted("../results/sorted_by_laptime_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
-            fSorted << "Position,driver,q1\n";
-            for (size_t i = 0; i < data.size(); i++)
-                fSorted << (i + 1) << "," << data[i].name << "," << fixed << setprecision(3) << data[i].lapTime << "\n";
+            if (dumpDatasets) {
+                ofstream fSorted("../results/sorted_by_laptime_n" + to_string(n) + "_d" + to_string(d+1) + ".csv");
+                fSorted << "Position,driver,q1\n";
+                for (size_t i = 0; i < data.size(); i++)
+                    fSorted << (i + 1) << "," << data[i].name << "," << fixed << setprecision(3) << data[i].lapTime << "\n";
+            }
             
             cout << ".";
         }
@@ -136,9 +154,13 @@ int main() {
         cout << " Avg: Comparisons=" << avgComp << ", Assignments=" << avgAssign << "\n";
     }
     
+    sink.finish();
     cout << "\nResults saved to ../results/\n";
-    cout << "Sorted data saved to ../results/sorted_*.csv\n";
-    cout << "Datasets saved to ../data/\n";
+    cout << sink.cells() << " cells" << (payloadMode ? " with sorted rows" : "") << " saved to ../results/results.jsonl\n";
+    if (dumpDatasets) {
+        cout << "Sorted data saved to ../results/sorted_*.csv\n";
+        cout << "Datasets saved to ../data/\n";
+    }
     
     return 0;
 }
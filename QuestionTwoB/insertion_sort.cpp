@@ -6,85 +6,104 @@
 
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
 #include <iomanip>
 
+#include "../common/bank_loader.hpp"
+#include "../common/cli.hpp"
+#include "../common/csv_writer.hpp"
+#include "../common/customer.hpp"
+#include "../common/index_sort.hpp"
+#include "../common/perf_counters.hpp"
+#include "../common/radix_sort.hpp"
+#include "../common/sorting.hpp"
+
 using namespace std;
 
-// Structure representing all 12 columns of the bank dataset
-struct Customer {
-    string id, score, country, gender, age, tenure, balance, products, card, active, churn;
-    double salary; // Key used for sorting
-};
+// Compact typed record for all 12 columns of the bank dataset (common/customer.hpp)
+using bank::Customer;
 
-// Loads all rows from the CSV file into a vector of Customer objects
-vector<Customer> loadData(string filename) {
-    vector<Customer> data;
-    ifstream file(filename);
-    string line, item;
+using BySalary = sorting::Key<sorting::Field<&Customer::salary>>;
 
-    if (!file.is_open()) return data;
+// Loads all rows from the CSV file into a vector of Customer objects (optionally in parallel)
+vector<Customer> loadData(string filename, unsigned threads) {
+    vector<Customer> data;
+    csv::LoadStats stats;
 
-    getline(file, line); // Skip the header row
-    while (getline(file, line)) {
-        stringstream ss(line);
-        vector<string> row;
-        while (getline(ss, item, ',')) row.push_back(item); // Split by comma
+    // Memory-mapped, tokenised in place; the header row is skipped
+    if (!bank::loadCsv(filename, data, &stats, threads)) return data;
 
-        if (row.size() >= 12) {
-            Customer c;
-            c.id = row[0]; c.score = row[1]; c.country = row[2];
-            c.gender = row[3]; c.age = row[4]; c.tenure = row[5];
-            c.balance = row[6]; c.products = row[7]; c.card = row[8];
-            c.active = row[9];
-            try { c.salary = stod(row[10]); } catch (...) { c.salary = 0.0; } // Convert salary to double
-            c.churn = row[11];
-            data.push_back(c);
-        }
-    }
+    csv::report(cout, stats);
     return data;
 }
 
-// Performs insertion sort on the dataset based on estimated_salary
-void insertionSort(vector<Customer>& data) {
-    int n = data.size();
-    for (int i = 1; i < n; i++) {
-        Customer key = data[i]; // Current record to be inserted
-        int j = i - 1;
-        // Shift records that have a higher salary than the key
-        while (j >= 0 && data[j].salary > key.salary) {
-            data[j + 1] = data[j];
-            j--;
-        }
-        data[j + 1] = key;
-    }
-}
-
-int main() {
+int main(int argc, char* argv[]) {
     string input = "dataset.csv";
-    vector<Customer> customers = loadData(input);
+    // --threads N parses newline-aligned chunks of the file on N threads
+    unsigned threads = 1;
+    string error;
+    if (!cli::checkFlags(argc, argv, {"--index", "--radix", "--perf", "--async-write"}, {"--threads"}, error) ||
+        !cli::intValue(argc, argv, "--threads", threads, 1, 1024, error)) {
+        cout << "Error: " << error << endl;
+        return 1;
+    }
+    vector<Customer> customers = loadData(input, threads);
 
     if (customers.empty()) {
         cout << "Error loading data." << endl;
         return 1;
     }
 
+    // --index sorts compact (salary, row) pairs and streams rows in that order at output time
+    bool indexMode = cli::has(argc, argv, "--index");
+    // --radix replaces insertion sort with the LSD radix sort on the salary bits
+    bool radixMode = cli::has(argc, argv, "--radix");
+    vector<sorting::Keyed<double>> order;
+    auto sortFn = [&] {
+        if (indexMode && radixMode)
+            sorting::radixSort(order, sorting::ByKeyed<double>());
+        else if (indexMode)
+            sorting::insertionSort(order, sorting::ByKeyed<double>());
+        else if (radixMode)
+            sorting::radixSort(customers, BySalary());
+        else
+            sorting::insertionSort(customers, BySalary()); // uncounted, full speed
+    };
+    if (indexMode)
+        order = sorting::makeIndex(customers, sorting::Field<&Customer::salary>());
+
     cout << "Sorting " << customers.size() << " records by Estimated Salary..." << endl;
-    insertionSort(customers);
+    if (cli::has(argc, argv, "--perf")) {
+        // Hardware counters around the sort, saved next to the sorted output
+        perf::CounterGroup counters;
+        perf::Sample sample = perf::measure(counters, sortFn);
+        ofstream fperf("perf_counters.csv");
+        fperf << "algorithm,rows," << perf::header() << "\n";
+        fperf << (radixMode ? "radix_sort" : "insertion_sort") << (indexMode ? "_index," : ",") << customers.size() << ",";
+        perf::writeSample(fperf, sample);
+        fperf << "\n";
+        cout << (counters.available() ? "Hardware counters saved to perf_counters.csv" : "Hardware counters unavailable (NA)") << endl;
+    } else {
+        sortFn();
+    }
 
-    ofstream fout("sorted_dataset.csv");
+    // --async-write formats the next buffer while a writer thread flushes the last one
+    csv::Writer fout("sorted_dataset.csv", csv::WRITE_BUFFER_BYTES, cli::has(argc, argv, "--async-write"));
     // Write original header back to the file
-    fout << "customer_id,credit_score,country,gender,age,tenure,balance,products_number,credit_card,active_member,estimated_salary,churn\n";
+    fout.put(bank::HEADER).put('\n');
     
-    for (const auto& c : customers) {
-        fout << c.id << "," << c.score << "," << c.country << "," << c.gender << ","
-             << c.age << "," << c.tenure << "," << c.balance << "," << c.products << ","
-             << c.card << "," << c.active << "," << fixed << setprecision(2) << c.salary << ","
-             << c.churn << "\n";
+    if (indexMode)
+        sorting::forEachInOrder(customers, order, [&](const Customer& c) { bank::writeLine(fout, c); });
+    else
+        for (const auto& c : customers)
+            bank::writeLine(fout, c);
+    if (!fout.finish()) {
+        cout << "Error writing sorted_dataset.csv" << endl;
+        return 1;
     }
 
+    csv::report(cout, fout.stats(customers.size()), "Wrote");
     cout << "Success! Sorted data saved to sorted_dataset.csv" << endl;
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,120 @@
+/**
+ * @file bank_loader.hpp
+ * @brief Loads a bank CSV into compact Customer records
+ * @details The file is memory-mapped and each line is tokenised in place by
+ *          bank::parseLine (string_views + from_chars), replacing the old
+ *          getline / stringstream / vector<string> / stod loop.
+ *
+ *          With more than one thread the body is cut into newline-aligned
+ *          chunks, each parsed by its own worker into a private vector; the
+ *          vectors are then copied into the output in chunk order, so row order
+ *          is identical to the serial loader.
+ */
+
+#ifndef DAA_BANK_LOADER_HPP
+#define DAA_BANK_LOADER_HPP
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "csv_mmap.hpp"
+#include "customer.hpp"
+
+namespace bank {
+
+/// Smallest chunk worth handing to its own parser thread.
+inline constexpr std::size_t MIN_CHUNK_BYTES = 64 * 1024;
+
+/**
+ * @brief Appends every valid row in `text` to `out`.
+ * @return The number of lines that did not parse.
+ */
+inline std::size_t parseRows(std::string_view text, std::vector<Customer>& out) {
+    out.reserve(out.size() + text.size() / 64); // ~65 bytes per row in the bank extracts
+    std::size_t skipped = 0;
+    csv::forEachLine(text, [&](std::string_view line) {
+        Customer c;
+        if (parseLine(line, c)) out.push_back(c);
+        else skipped++;
+    });
+    return skipped;
+}
+
+/**
+ * @brief Splits `text` into at most `parts` pieces, each ending just after a newline.
+ */
+inline std::vector<std::string_view> splitChunks(std::string_view text, unsigned parts) {
+    std::vector<std::string_view> chunks;
+    std::size_t begin = 0;
+    for (unsigned t = 0; t < parts && begin < text.size(); t++) {
+        std::size_t end = text.size();
+        if (t + 1 < parts) {
+            std::size_t target = std::max(begin, text.size() / parts * (t + 1));
+            std::size_t nl = text.find('\n', target);
+            end = nl == std::string_view::npos ? text.size() : nl + 1;
+        }
+        chunks.push_back(text.substr(begin, end - begin));
+        begin = end;
+    }
+    return chunks;
+}
+
+/**
+ * @brief Parses the chunks of `text` on up to `threads` workers, keeping row order.
+ * @return The number of lines that did not parse.
+ */
+inline std::size_t parseRowsParallel(std::string_view text, std::vector<Customer>& out, unsigned threads) {
+    threads = (unsigned)std::min<std::size_t>(threads, text.size() / MIN_CHUNK_BYTES + 1);
+    if (threads <= 1) return parseRows(text, out);
+
+    std::vector<std::string_view> chunks = splitChunks(text, threads);
+    std::vector<std::vector<Customer>> parts(chunks.size());
+    std::vector<std::size_t> skipped(chunks.size(), 0);
+    std::vector<std::thread> workers;
+    for (std::size_t t = 0; t < chunks.size(); t++)
+        workers.emplace_back([&, t] { skipped[t] = parseRows(chunks[t], parts[t]); });
+    for (auto& w : workers) w.join();
+
+    // Concatenate in chunk order; each worker copies its part to its offset
+    std::vector<std::size_t> offset(parts.size() + 1, 0);
+    for (std::size_t t = 0; t < parts.size(); t++)
+        offset[t + 1] = offset[t] + parts[t].size();
+    out.resize(offset.back());
+    workers.clear();
+    for (std::size_t t = 0; t < parts.size(); t++)
+        workers.emplace_back([&, t] { std::copy(parts[t].begin(), parts[t].end(), out.begin() + offset[t]); });
+    for (auto& w : workers) w.join();
+    return std::accumulate(skipped.begin(), skipped.end(), (std::size_t)0);
+}
+
+/**
+ * @brief Parses every data row of the bank CSV at `path` into `out`.
+ * @details Rows with fewer than 12 columns or malformed values are skipped.
+ * @param stats If non-null, receives bytes/rows parsed, rows skipped and elapsed time.
+ * @param threads Parser threads; 1 parses serially.
+ * @return false if the file could not be opened.
+ */
+inline bool loadCsv(const std::string& path, std::vector<Customer>& out,
+                    csv::LoadStats* stats = nullptr, unsigned threads = 1) {
+    csv::Stopwatch clock;
+    csv::MappedFile file(path);
+    if (!file.ok()) return false;
+
+    out.clear();
+    std::size_t skipped = parseRowsParallel(csv::skipLine(file.view()), out, threads);
+
+    if (stats) {
+        stats->bytes = file.view().size();
+        stats->rows = out.size();
+        stats->skipped = skipped;
+        stats->seconds = clock.seconds();
+    }
+    return true;
+}
+
+} // namespace bank
+
+#endif // DAA_BANK_LOADER_HPP
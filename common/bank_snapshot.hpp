@@ -0,0 +1,247 @@
+/**
+ * @file bank_snapshot.hpp
+ * @brief Binary columnar snapshot of a parsed bank CSV, reused across runs
+ * @details Parsing is most of the start-up cost of every bank menu option.
+ *          After the first parse the rows are also written to `<csv>.snap`:
+ *          a 64-byte header followed by one column per field (salary, balance,
+ *          id, score, age, tenure, products, country, gender, packed flags),
+ *          each starting on an 8-byte boundary. Later loads memory-map the
+ *          snapshot and assemble the rows from the columns, which is a
+ *          sequential copy rather than a text parse.
+ *
+ *          The header records the source CSV's size and modification time, and
+ *          how many of its lines were skipped as malformed, so a load from the
+ *          snapshot reports them as the parse did; a
+ *          snapshot whose source has changed, or whose magic (which carries the
+ *          layout version) or length does not match, is ignored and rewritten. Snapshots are in native
+ *          byte order and meant as a local cache, not an exchange format. They
+ *          are written to a temporary name and renamed into place, so a reader
+ *          never sees a half-written file.
+ */
+
+#ifndef DAA_BANK_SNAPSHOT_HPP
+#define DAA_BANK_SNAPSHOT_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "bank_loader.hpp"
+#include "csv_mmap.hpp"
+#include "customer.hpp"
+
+namespace bank {
+
+/// Identifies (and versions) the snapshot layout.
+inline constexpr char SNAPSHOT_MAGIC[8] = {'D', 'A', 'A', 'S', 'N', 'A', 'P', '2'};
+
+/**
+ * @struct SnapshotHeader
+ * @brief First 64 bytes of a snapshot file.
+ */
+struct SnapshotHeader {
+    char magic[8];
+    std::uint64_t rows;
+    std::uint64_t sourceSize;  ///< Size of the CSV the rows were parsed from.
+    std::int64_t sourceMtime;  ///< Its modification time (file clock ticks).
+    std::uint64_t skipped;     ///< Lines of the CSV the parser rejected.
+    std::uint8_t reserved[24];
+};
+
+static_assert(sizeof(SnapshotHeader) == 64, "snapshot header layout is fixed");
+
+/// @brief Byte sizes of the ten columns, in file order, for one row.
+inline constexpr std::size_t SNAPSHOT_COLUMN_BYTES[] = {8, 8, 4, 2, 1, 1, 1, 1, 1, 1};
+
+/// @brief Offset of every column (and, last, the file length) for `rows` rows.
+inline std::vector<std::size_t> snapshotLayout(std::uint64_t rows) {
+    std::vector<std::size_t> offset = {sizeof(SnapshotHeader)};
+    for (std::size_t bytes : SNAPSHOT_COLUMN_BYTES) {
+        std::size_t end = offset.back() + bytes * rows;
+        offset.push_back((end + 7) / 8 * 8);
+    }
+    return offset;
+}
+
+/// @brief Snapshot file that caches the CSV at `csvPath`.
+inline std::string snapshotPath(const std::string& csvPath) {
+    return csvPath + ".snap";
+}
+
+/**
+ * @brief Size and modification time of `path`, as stored in the header.
+ * @return false if the file cannot be examined.
+ */
+inline bool sourceIdentity(const std::string& path, std::uint64_t& size, std::int64_t& mtime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto time = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    mtime = (std::int64_t)time.time_since_epoch().count();
+    return true;
+}
+
+/**
+ * @brief Writes `rows` as the snapshot of `csvPath`.
+ * @param skipped Lines of the CSV that did not parse into `rows`.
+ * @return false if the snapshot could not be written (the cache is then just skipped).
+ */
+inline bool writeSnapshot(const std::string& csvPath, const std::vector<Customer>& rows, std::size_t skipped = 0) {
+    SnapshotHeader header = {};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof header.magic);
+    header.rows = rows.size();
+    header.skipped = skipped;
+    if (!sourceIdentity(csvPath, header.sourceSize, header.sourceMtime)) return false;
+
+    const std::string path = snapshotPath(csvPath);
+    const std::string temp = path + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write((const char*)&header, sizeof header);
+
+        std::vector<char> column;
+        std::vector<std::size_t> offset = snapshotLayout(rows.size());
+        auto put = [&](std::size_t c, auto field) {
+            using V = decltype(field(rows[0]));
+            column.assign(offset[c + 1] - offset[c], 0); // zero padding included
+            for (std::size_t i = 0; i < rows.size(); i++) {
+                V v = field(rows[i]);
+                std::memcpy(column.data() + i * sizeof(V), &v, sizeof(V));
+            }
+            out.write(column.data(), column.size());
+        };
+        if (!rows.empty()) {
+            put(0, [](const Customer& c) { return c.salary; });
+            put(1, [](const Customer& c) { return c.balance; });
+            put(2, [](const Customer& c) { return c.id; });
+            put(3, [](const Customer& c) { return c.score; });
+            put(4, [](const Customer& c) { return c.age; });
+            put(5, [](const Customer& c) { return c.tenure; });
+            put(6, [](const Customer& c) { return c.products; });
+            put(7, [](const Customer& c) { return (std::uint8_t)c.country; });
+            put(8, [](const Customer& c) { return (std::uint8_t)c.gender; });
+            put(9, [](const Customer& c) { return std::uint8_t(c.card | c.active << 1 | c.churn << 2); });
+        }
+        if (!out) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec) std::filesystem::remove(temp, ec);
+    return !ec;
+}
+
+/**
+ * @brief Loads `out` from the snapshot of `csvPath` if it exists and matches the CSV.
+ * @param threads Threads assembling rows from the columns.
+ * @param skipped If non-null, receives the number of CSV lines the original parse skipped.
+ * @return false if there is no usable snapshot (`out` is then left empty).
+ */
+inline bool readSnapshot(const std::string& csvPath, std::vector<Customer>& out, unsigned threads = 1,
+                         std::size_t* skipped = nullptr) {
+    out.clear();
+    std::uint64_t size;
+    std::int64_t mtime;
+    if (!sourceIdentity(csvPath, size, mtime)) return false;
+
+    csv::MappedFile file(snapshotPath(csvPath));
+    std::string_view bytes = file.view();
+    if (!file.ok() || bytes.size() < sizeof(SnapshotHeader)) return false;
+    SnapshotHeader header;
+    std::memcpy(&header, bytes.data(), sizeof header);
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof header.magic) != 0 || header.sourceSize != size
+        || header.sourceMtime != mtime)
+        return false;
+    std::vector<std::size_t> offset = snapshotLayout(header.rows);
+    if (offset.back() != bytes.size()) return false;
+    if (skipped) *skipped = header.skipped;
+
+    // Columns start on 8-byte boundaries of a page-aligned mapping
+    const char* base = bytes.data();
+    auto column = [&](std::size_t c) { return base + offset[c]; };
+    const double* salary = (const double*)column(0);
+    const double* balance = (const double*)column(1);
+    const std::uint32_t* id = (const std::uint32_t*)column(2);
+    const std::uint16_t* score = (const std::uint16_t*)column(3);
+    const std::uint8_t* age = (const std::uint8_t*)column(4);
+    const std::uint8_t* tenure = (const std::uint8_t*)column(5);
+    const std::uint8_t* products = (const std::uint8_t*)column(6);
+    const std::uint8_t* country = (const std::uint8_t*)column(7);
+    const std::uint8_t* gender = (const std::uint8_t*)column(8);
+    const std::uint8_t* flags = (const std::uint8_t*)column(9);
+
+    out.resize(header.rows);
+    auto assemble = [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            Customer& c = out[i];
+            c.salary = salary[i];
+            c.balance = balance[i];
+            c.id = id[i];
+            c.score = score[i];
+            c.age = age[i];
+            c.tenure = tenure[i];
+            c.products = products[i];
+            c.country = (Country)country[i];
+            c.gender = (Gender)gender[i];
+            c.card = flags[i] & 1;
+            c.active = (flags[i] >> 1) & 1;
+            c.churn = (flags[i] >> 2) & 1;
+        }
+    };
+
+    // Row ranges per thread, as in parseRowsParallel
+    threads = (unsigned)std::min<std::size_t>(threads, out.size() / (MIN_CHUNK_BYTES / 4) + 1);
+    if (threads <= 1) {
+        assemble(0, out.size());
+        return true;
+    }
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++)
+        workers.emplace_back(assemble, out.size() * t / threads, out.size() * (t + 1) / threads);
+    for (auto& w : workers) w.join();
+    return true;
+}
+
+/// @brief Where loadCached got its rows from.
+enum class LoadSource { Csv, Snapshot };
+
+/**
+ * @brief Loads the bank CSV at `path`, from its snapshot when that is up to date.
+ * @details Otherwise parses the CSV (loadCsv) and writes a fresh snapshot for next time.
+ * @param stats If non-null, receives the bytes read (snapshot or CSV), rows, rows skipped and time.
+ * @param source If non-null, receives which of the two was used.
+ * @return false if the CSV could not be opened.
+ */
+inline bool loadCached(const std::string& path, std::vector<Customer>& out, csv::LoadStats* stats = nullptr,
+                       unsigned threads = 1, LoadSource* source = nullptr) {
+    csv::Stopwatch clock;
+    std::size_t skipped = 0;
+    if (readSnapshot(path, out, threads, &skipped)) {
+        if (source) *source = LoadSource::Snapshot;
+        if (stats) {
+            stats->bytes = snapshotLayout(out.size()).back();
+            stats->rows = out.size();
+            stats->skipped = skipped;
+            stats->seconds = clock.seconds();
+        }
+        return true;
+    }
+
+    csv::LoadStats parsed;
+    if (!loadCsv(path, out, &parsed, threads)) return false;
+    if (stats) *stats = parsed;
+    if (source) *source = LoadSource::Csv;
+    writeSnapshot(path, out, parsed.skipped);
+    return true;
+}
+
+} // namespace bank
+
+#endif // DAA_BANK_SNAPSHOT_HPP
@@ -0,0 +1,93 @@
+/**
+ * @file cli.hpp
+ * @brief Minimal `--flag value` command-line lookup shared by the programs
+ * @details Numeric values are parsed strictly: `intValue` rejects anything that is
+ *          not a whole number in the caller's range, and `checkFlags` rejects
+ *          arguments the program does not know, so a typo fails loudly instead
+ *          of running with a default.
+ */
+
+#ifndef DAA_CLI_HPP
+#define DAA_CLI_HPP
+
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace cli {
+
+/// @brief Returns true if `flag` appears anywhere on the command line.
+inline bool has(int argc, char* argv[], const std::string& flag) {
+    for (int i = 1; i < argc; i++)
+        if (flag == argv[i]) return true;
+    return false;
+}
+
+/// @brief Returns the argument following `flag`, or nullptr if absent.
+inline const char* value(int argc, char* argv[], const std::string& flag) {
+    for (int i = 1; i + 1 < argc; i++)
+        if (flag == argv[i]) return argv[i + 1];
+    return nullptr;
+}
+
+/**
+ * @brief Reads the integer after `flag` into `out`, which keeps its value if the flag is absent.
+ * @param error Receives a message if the value is missing, not a whole number or outside [min, max].
+ * @return false if the flag is given with a bad or missing value.
+ */
+template <class Int>
+bool intValue(int argc, char* argv[], const std::string& flag, Int& out, long long min, long long max,
+              std::string& error) {
+    const char* v = value(argc, argv, flag);
+    if (!v) {
+        if (!has(argc, argv, flag)) return true;
+        error = flag + " needs a value";
+        return false;
+    }
+    const char* end = v + std::strlen(v);
+    long long parsed = 0;
+    auto [stop, ec] = std::from_chars(v, end, parsed);
+    if (v == end || ec != std::errc() || stop != end || parsed < min || parsed > max) {
+        error = "bad " + flag + " " + v + " (want a whole number from " + std::to_string(min) + " to " +
+                std::to_string(max) + ")";
+        return false;
+    }
+    out = (Int)parsed;
+    return true;
+}
+
+/**
+ * @brief Checks that every argument is a known switch, or a known option followed by its value.
+ * @param switches Flags that stand alone, e.g. "--perf".
+ * @param options Flags that take the next argument as their value, e.g. "--reps".
+ * @param error Receives a message naming the first argument that is not one of them.
+ * @return false if an argument is unknown or an option has no value.
+ */
+inline bool checkFlags(int argc, char* argv[], const std::vector<std::string>& switches,
+                       const std::vector<std::string>& options, std::string& error) {
+    auto known = [](const std::vector<std::string>& list, const char* arg) {
+        for (const std::string& flag : list)
+            if (flag == arg) return true;
+        return false;
+    };
+    for (int i = 1; i < argc; i++) {
+        if (known(switches, argv[i])) continue;
+        if (known(options, argv[i])) {
+            if (i + 1 >= argc) {
+                error = std::string(argv[i]) + " needs a value";
+                return false;
+            }
+            i++;
+            continue;
+        }
+        error = std::string(argv[i][0] == '-' ? "unknown flag " : "unexpected argument ") + argv[i];
+        return false;
+    }
+    return true;
+}
+
+} // namespace cli
+
+#endif // DAA_CLI_HPP
@@ -0,0 +1,156 @@
+/**
+ * @file csv_mmap.hpp
+ * @brief Memory-mapped, zero-copy CSV reading
+ * @details MappedFile maps the whole input read-only; lines and fields are
+ *          string_views into that mapping, so nothing is copied or allocated
+ *          per row. Numbers are then parsed with std::from_chars by the record
+ *          parsers. Platforms without mmap fall back to reading the file into
+ *          one buffer, which keeps the same interface.
+ */
+
+#ifndef DAA_CSV_MMAP_HPP
+#define DAA_CSV_MMAP_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define DAA_HAVE_MMAP 1
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+namespace csv {
+
+/**
+ * @class MappedFile
+ * @brief Read-only view of a whole file (mmap where available).
+ */
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+#if defined(DAA_HAVE_MMAP)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            size_ = (std::size_t)st.st_size;
+            if (size_ == 0) {
+                ok_ = true;
+            } else {
+                void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    data_ = (const char*)p;
+                    madvise(p, size_, MADV_SEQUENTIAL);
+                    ok_ = true;
+                }
+            }
+        }
+        ::close(fd); // the mapping stays valid after close
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return;
+        std::ostringstream ss;
+        ss << in.rdbuf();
+        buffer_ = ss.str();
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+        ok_ = true;
+#endif
+    }
+
+    ~MappedFile() {
+#if defined(DAA_HAVE_MMAP)
+        if (data_) munmap((void*)data_, size_);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// @brief True if the file could be opened (an empty file is ok).
+    bool ok() const { return ok_; }
+
+    /// @brief The whole file contents.
+    std::string_view view() const { return std::string_view(data_ ? data_ : "", data_ ? size_ : 0); }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool ok_ = false;
+#if !defined(DAA_HAVE_MMAP)
+    std::string buffer_;
+#endif
+};
+
+/// @brief Returns `text` without its first line (the header).
+inline std::string_view skipLine(std::string_view text) {
+    std::size_t nl = text.find('\n');
+    return nl == std::string_view::npos ? std::string_view() : text.substr(nl + 1);
+}
+
+/**
+ * @brief Calls `fn(line)` for every non-empty line; '\n' and a trailing '\r' are stripped.
+ */
+template <class Fn>
+void forEachLine(std::string_view text, Fn fn) {
+    while (!text.empty()) {
+        std::size_t nl = text.find('\n');
+        std::string_view line = text.substr(0, nl);
+        text = nl == std::string_view::npos ? std::string_view() : text.substr(nl + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (!line.empty()) fn(line);
+    }
+}
+
+/**
+ * @struct LoadStats
+ * @brief Bytes and rows parsed by a loader, and how long it took.
+ */
+struct LoadStats {
+    std::size_t bytes = 0;
+    std::size_t rows = 0;
+    std::size_t skipped = 0; ///< Data lines the parser rejected.
+    double seconds = 0;
+
+    /// @brief Parse throughput in MB/s (10^6 bytes).
+    double mbPerSec() const { return seconds > 0 ? bytes / seconds / 1e6 : 0.0; }
+};
+
+/// @brief Prints "<verb> R rows (B MB) in T ms: X MB/s" without changing `out`'s number format.
+/// Skipped lines, if any, follow on their own line.
+inline void report(std::ostream& out, const LoadStats& s, const char* verb = "Parsed") {
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << verb << " " << s.rows << " rows (" << std::fixed << std::setprecision(2) << s.bytes / 1e6
+        << " MB) in " << s.seconds * 1e3 << " ms: " << s.mbPerSec() << " MB/s\n";
+    if (s.skipped) out << "Skipped " << s.skipped << " malformed or unrecognised rows\n";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+/// Wall-clock stopwatch used by the loaders.
+class Stopwatch {
+public:
+    void restart() { start_ = std::chrono::steady_clock::now(); }
+
+    double seconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+};
+
+} // namespace csv
+
+#endif // DAA_CSV_MMAP_HPP
@@ -0,0 +1,268 @@
+/**
+ * @file csv_writer.hpp
+ * @brief Buffered CSV output: to_chars formatting, large write() calls
+ * @details Writing rows through an ofstream formats every field with the
+ *          stream's locale-aware machinery and pushes them through a small
+ *          stream buffer. Writer formats numbers with std::to_chars straight
+ *          into one large buffer (1 MiB by default) and hands full buffers to
+ *          the OS with write(2), looping over partial writes.
+ *
+ *          With `background` set, full buffers go to a writer thread instead
+ *          (at most WRITE_BUFFERS in flight, then the producer waits), so
+ *          formatting the next rows overlaps the system calls for the previous
+ *          ones. Output bytes are identical either way.
+ */
+
+#ifndef DAA_CSV_WRITER_HPP
+#define DAA_CSV_WRITER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "csv_mmap.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace csv {
+
+/// Default output buffer size.
+inline constexpr std::size_t WRITE_BUFFER_BYTES = std::size_t(1) << 20;
+/// Buffers a background writer may have filled or in flight.
+inline constexpr std::size_t WRITE_BUFFERS = 3;
+
+/**
+ * @class Writer
+ * @brief Appends bytes and formatted fields to a file through a large buffer.
+ */
+class Writer {
+public:
+    /**
+     * @param bufferBytes Size of each buffer (at least 4 KiB).
+     * @param background Write full buffers on a separate thread.
+     */
+    explicit Writer(const std::string& path, std::size_t bufferBytes = WRITE_BUFFER_BYTES,
+                    bool background = false)
+        : capacity(bufferBytes < 4096 ? 4096 : bufferBytes) {
+#if defined(__unix__) || defined(__APPLE__)
+        fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        opened = fd >= 0;
+#else
+        file = std::fopen(path.c_str(), "wb");
+        opened = file != nullptr;
+#endif
+        buffer.resize(capacity);
+        if (opened && background) thread = std::thread([this] { writerLoop(); });
+    }
+
+    ~Writer() { finish(); }
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    /// @brief False if the file could not be opened or a write failed.
+    bool ok() const { return opened && !failed; }
+
+    /// @brief Bytes handed to the writer so far.
+    std::size_t bytes() const { return total; }
+
+    /// @brief Bytes, `rows` and seconds from the first byte to finish() (or now), for csv::report.
+    LoadStats stats(std::size_t rows = 0) const {
+        LoadStats s;
+        s.bytes = total;
+        s.rows = rows;
+        s.seconds = closed ? elapsed : clock.seconds();
+        return s;
+    }
+
+    /**
+     * @brief Lets `fill(char* at)` write at most `maxBytes` and return one past its last byte.
+     */
+    template <class Fill>
+    void append(std::size_t maxBytes, Fill fill) {
+        if (total == 0) clock.restart();
+        if (used + maxBytes > capacity) flush();
+        if (maxBytes > capacity) { // oversized record: format aside, then copy
+            std::vector<char> big(maxBytes);
+            write(big.data(), fill(big.data()) - big.data());
+            return;
+        }
+        char* at = buffer.data() + used;
+        std::size_t n = fill(at) - at;
+        used += n;
+        total += n;
+    }
+
+    /// @brief Copies `n` bytes, flushing as many full buffers as that takes.
+    void write(const void* data, std::size_t n) {
+        const char* from = (const char*)data;
+        if (total == 0) clock.restart();
+        while (n > 0) {
+            if (used == capacity) flush();
+            std::size_t k = std::min(n, capacity - used);
+            std::memcpy(buffer.data() + used, from, k);
+            used += k;
+            total += k;
+            from += k;
+            n -= k;
+        }
+    }
+
+    Writer& put(std::string_view s) {
+        write(s.data(), s.size());
+        return *this;
+    }
+
+    Writer& put(char c) {
+        if (total == 0) clock.restart();
+        if (used == capacity) flush();
+        buffer[used++] = c;
+        total++;
+        return *this;
+    }
+
+    /// @brief Integer in decimal.
+    template <class Int, class = std::enable_if_t<std::is_integral<Int>::value>>
+    Writer& put(Int v) {
+        append(24, [v](char* at) { return std::to_chars(at, at + 24, v).ptr; });
+        return *this;
+    }
+
+    /// @brief Shortest representation that reads back to the same double.
+    Writer& put(double v) {
+        append(32, [v](char* at) { return std::to_chars(at, at + 32, v).ptr; });
+        return *this;
+    }
+
+    /// @brief Fixed notation with `decimals` digits, like `fixed << setprecision(decimals)`.
+    Writer& fixed(double v, int decimals) {
+        const std::size_t most = 320 + decimals; // 1e308 has 309 integer digits
+        append(most, [&](char* at) { return std::to_chars(at, at + most, v, std::chars_format::fixed, decimals).ptr; });
+        return *this;
+    }
+
+    /// @brief Writes what is buffered, stops the writer thread and closes the file; returns ok().
+    bool finish() {
+        if (closed) return ok();
+        flush();
+        if (thread.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            filled.notify_one();
+            thread.join();
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        if (opened && ::close(fd) != 0) failed = true;
+#else
+        if (opened && std::fclose(file) != 0) failed = true;
+#endif
+        elapsed = clock.seconds();
+        closed = true;
+        return ok();
+    }
+
+private:
+    std::size_t capacity;
+    std::vector<char> buffer;
+    std::size_t used = 0, total = 0;
+    bool opened = false, closed = false;
+    std::atomic<bool> failed{false}; // also set by the writer thread
+    Stopwatch clock;
+    double elapsed = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = -1;
+#else
+    std::FILE* file = nullptr;
+#endif
+
+    // Background mode: full buffers queue up for the thread, emptied ones come back
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable filled, drained;
+    std::deque<std::pair<std::vector<char>, std::size_t>> queue;
+    std::vector<std::vector<char>> spare;
+    std::size_t buffers = 1;
+    bool stopping = false;
+
+    bool rawWrite(const char* data, std::size_t n) {
+#if defined(__unix__) || defined(__APPLE__)
+        while (n > 0) {
+            ssize_t k = ::write(fd, data, n);
+            if (k < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += k;
+            n -= (std::size_t)k;
+        }
+        return true;
+#else
+        return std::fwrite(data, 1, n, file) == n;
+#endif
+    }
+
+    void flush() {
+        if (used == 0) return;
+        if (!opened) {
+            used = 0;
+            return;
+        }
+        if (!thread.joinable()) {
+            if (!rawWrite(buffer.data(), used)) failed = true;
+            used = 0;
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        queue.emplace_back(std::move(buffer), used);
+        filled.notify_one();
+        if (spare.empty() && buffers < WRITE_BUFFERS) {
+            buffers++;
+            buffer.assign(capacity, 0);
+        } else {
+            drained.wait(lock, [this] { return !spare.empty(); });
+            buffer = std::move(spare.back());
+            spare.pop_back();
+        }
+        used = 0;
+    }
+
+    void writerLoop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            filled.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return; // stopping, and everything is written
+            auto [data, n] = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            bool ok = rawWrite(data.data(), n);
+            lock.lock();
+            if (!ok) failed = true;
+            spare.push_back(std::move(data));
+            drained.notify_one();
+        }
+    }
+};
+
+} // namespace csv
+
+#endif // DAA_CSV_WRITER_HPP
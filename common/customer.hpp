@@ -0,0 +1,187 @@
+/**
+ * @file customer.hpp
+ * @brief Compact typed bank customer record with CSV parse / write
+ * @details The bank CSV has 12 columns:
+ *          customer_id,credit_score,country,gender,age,tenure,balance,
+ *          products_number,credit_card,active_member,estimated_salary,churn
+ *
+ *          Storing them as eleven std::string fields made every record ~360
+ *          bytes and every shift, swap or merge copy up to eleven heap copies.
+ *          Here numbers are integers/doubles, country and gender are one-byte
+ *          enums and the three yes/no columns are bitfields: 32 bytes and
+ *          trivially copyable. Values round-trip to the same CSV text (balance
+ *          uses the shortest representation, salary two decimals).
+ */
+
+#ifndef DAA_CUSTOMER_HPP
+#define DAA_CUSTOMER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "csv_writer.hpp"
+
+namespace bank {
+
+/// Column header shared by every bank CSV the programs read or write.
+inline constexpr const char* HEADER =
+    "customer_id,credit_score,country,gender,age,tenure,balance,products_number,"
+    "credit_card,active_member,estimated_salary,churn";
+
+/// Number of columns in a bank CSV row.
+inline constexpr int COLUMNS = 12;
+
+/// Longest line formatLine() can write: a salary of 1e308 alone has 309 integer digits.
+inline constexpr std::size_t MAX_LINE = 400;
+
+enum class Country : std::uint8_t { France, Spain, Germany };
+enum class Gender : std::uint8_t { Female, Male };
+
+/**
+ * @struct Customer
+ * @brief One bank customer; the sort key `salary` comes first.
+ */
+struct Customer {
+    double salary;          ///< estimated_salary (sort key)
+    double balance;         ///< balance
+    std::uint32_t id;       ///< customer_id
+    std::uint16_t score;    ///< credit_score
+    std::uint8_t age;       ///< age in years
+    std::uint8_t tenure;    ///< years with the bank
+    std::uint8_t products;  ///< products_number
+    Country country;
+    Gender gender;
+    std::uint8_t card : 1;   ///< credit_card flag
+    std::uint8_t active : 1; ///< active_member flag
+    std::uint8_t churn : 1;  ///< churn flag
+};
+
+static_assert(std::is_trivially_copyable<Customer>::value, "Customer must stay memcpy-able");
+static_assert(sizeof(Customer) <= 32, "Customer should stay within half a cache line");
+
+/// @brief Country name as written in the CSV.
+inline std::string_view countryName(Country c) {
+    switch (c) {
+        case Country::France: return "France";
+        case Country::Spain: return "Spain";
+        default: return "Germany";
+    }
+}
+
+/// @brief Gender as written in the CSV.
+inline std::string_view genderName(Gender g) {
+    return g == Gender::Female ? "Female" : "Male";
+}
+
+/// @brief Parses an unsigned integer field; the whole field must be consumed.
+template <class U>
+bool parseField(std::string_view field, U& out) {
+    auto r = std::from_chars(field.data(), field.data() + field.size(), out);
+    return r.ec == std::errc() && r.ptr == field.data() + field.size();
+}
+
+/// @brief Parses a 0/1 flag field.
+inline bool parseFlag(std::string_view field, bool& out) {
+    if (field == "0") { out = false; return true; }
+    if (field == "1") { out = true; return true; }
+    return false;
+}
+
+/**
+ * @brief Fills `c` from the twelve column values of one row.
+ * @details An unparsable salary becomes 0.0, as with the old stod fallback.
+ *          A country or gender outside the enums has no code, so the row is
+ *          rejected; the loaders count such rows as skipped (csv::LoadStats).
+ * @return false if any other column is malformed.
+ */
+inline bool parseFields(const std::string_view* f, Customer& c) {
+    if (f[2] == "France") c.country = Country::France;
+    else if (f[2] == "Spain") c.country = Country::Spain;
+    else if (f[2] == "Germany") c.country = Country::Germany;
+    else return false;
+
+    if (f[3] == "Female") c.gender = Gender::Female;
+    else if (f[3] == "Male") c.gender = Gender::Male;
+    else return false;
+
+    bool card, active, churn;
+    if (!parseField(f[0], c.id) || !parseField(f[1], c.score) || !parseField(f[4], c.age)
+        || !parseField(f[5], c.tenure) || !parseField(f[6], c.balance)
+        || !parseField(f[7], c.products) || !parseFlag(f[8], card)
+        || !parseFlag(f[9], active) || !parseFlag(f[11], churn))
+        return false;
+    c.card = card;
+    c.active = active;
+    c.churn = churn;
+
+    if (!parseField(f[10], c.salary)) c.salary = 0.0;
+    return true;
+}
+
+/**
+ * @brief Parses one CSV line (without the newline) into `c`.
+ * @return false if the line has fewer than 12 columns or a malformed value.
+ */
+inline bool parseLine(std::string_view line, Customer& c) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    std::string_view fields[COLUMNS];
+    std::size_t start = 0;
+    for (int k = 0; k < COLUMNS; k++) {
+        std::size_t comma = line.find(',', start);
+        if (comma == std::string_view::npos) {
+            if (k != COLUMNS - 1) return false;
+            comma = line.size();
+        }
+        fields[k] = line.substr(start, comma - start);
+        start = comma + 1;
+    }
+    return parseFields(fields, c);
+}
+
+/**
+ * @brief Formats `c` as one CSV line (with trailing newline) into `buf`.
+ * @param buf Destination with room for at least MAX_LINE bytes.
+ * @return Pointer one past the last byte written.
+ */
+inline char* formatLine(const Customer& c, char* buf) {
+    char* p = buf;
+    auto put = [&p](std::string_view s) {
+        for (char ch : s) *p++ = ch;
+    };
+    auto num = [&p](auto v) { p = std::to_chars(p, p + 32, v).ptr; };
+
+    num(c.id); *p++ = ',';
+    num(c.score); *p++ = ',';
+    put(countryName(c.country)); *p++ = ',';
+    put(genderName(c.gender)); *p++ = ',';
+    num((unsigned)c.age); *p++ = ',';
+    num((unsigned)c.tenure); *p++ = ',';
+    num(c.balance); *p++ = ',';
+    num((unsigned)c.products); *p++ = ',';
+    *p++ = char('0' + c.card); *p++ = ',';
+    *p++ = char('0' + c.active); *p++ = ',';
+    p = std::to_chars(p, p + 320, c.salary, std::chars_format::fixed, 2).ptr; *p++ = ',';
+    *p++ = char('0' + c.churn);
+    *p++ = '\n';
+    return p;
+}
+
+/// @brief Writes `c` as one CSV line to `out`.
+inline void writeLine(std::ostream& out, const Customer& c) {
+    char buf[MAX_LINE];
+    out.write(buf, formatLine(c, buf) - buf);
+}
+
+/// @brief Formats `c` as one CSV line straight into the writer's buffer.
+inline void writeLine(csv::Writer& out, const Customer& c) {
+    out.append(MAX_LINE, [&c](char* at) { return formatLine(c, at); });
+}
+
+} // namespace bank
+
+#endif // DAA_CUSTOMER_HPP
@@ -0,0 +1,152 @@
+/**
+ * @file dictionary.hpp
+ * @brief Order-preserving dictionary encoding and counting sort
+ * @details Low-cardinality columns (the 16 generated names and ages, the bank
+ *          country and gender) are interned into dense codes 0..k-1 whose order
+ *          matches the order of the values: code(a) < code(b) exactly when
+ *          a < b. Sorting by such a column then needs no value comparisons at
+ *          all; countingSort places every row in one O(n + k) histogram and
+ *          scatter pass.
+ *
+ *          Encoding hashes each row's value once. The k distinct values are
+ *          sorted (k log k comparisons) and the first-seen ids remapped to
+ *          ranks. countingSort is stable and keeps the code column aligned
+ *          with the rows. A two-column order such as name-then-age is still a
+ *          single pass: combineCodes packs the pair into one code
+ *          (name * k_age + age), which is only 256 buckets for 16 x 16 values.
+ */
+
+#ifndef DAA_DICTIONARY_HPP
+#define DAA_DICTIONARY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "sorting.hpp"
+
+namespace sorting {
+
+/// Dictionary code of one value.
+using Code = std::uint32_t;
+
+/**
+ * @class Dictionary
+ * @brief Sorted distinct values of a column; a value's code is its rank.
+ */
+template <class V>
+class Dictionary {
+public:
+    Dictionary() = default;
+
+    /// @brief Builds from distinct values in any order.
+    explicit Dictionary(std::vector<V> distinct) : values(std::move(distinct)) {
+        std::sort(values.begin(), values.end());
+        for (Code c = 0; c < values.size(); c++) index.emplace(values[c], c);
+    }
+
+    /// @brief Number of distinct values (k).
+    std::size_t size() const { return values.size(); }
+
+    /// @brief Code of `v`, which must be in the dictionary.
+    Code code(const V& v) const { return index.at(v); }
+
+    /// @brief Value of code `c`.
+    const V& value(Code c) const { return values[c]; }
+
+private:
+    std::vector<V> values;
+    std::unordered_map<V, Code> index;
+};
+
+/**
+ * @struct EncodedColumn
+ * @brief A column's dictionary plus one code per row, in row order.
+ */
+template <class V>
+struct EncodedColumn {
+    Dictionary<V> dict;
+    std::vector<Code> codes;
+};
+
+/**
+ * @brief Dictionary-encodes the column `proj` of `rows` with one hash lookup per row.
+ * @param proj Projection returning the value, e.g. Field<&Record::name>().
+ */
+template <class T, class Proj>
+auto encodeColumn(const std::vector<T>& rows, Proj proj) {
+    using V = std::decay_t<decltype(proj(rows[0]))>;
+    EncodedColumn<V> column;
+    column.codes.resize(rows.size());
+
+    // First-seen ids, then remapped to ranks once the distinct values are known
+    std::unordered_map<V, Code> seen;
+    std::vector<V> distinct;
+    for (std::size_t i = 0; i < rows.size(); i++) {
+        const V& v = proj(rows[i]);
+        auto it = seen.find(v);
+        if (it == seen.end()) {
+            it = seen.emplace(v, (Code)distinct.size()).first;
+            distinct.push_back(v);
+        }
+        column.codes[i] = it->second;
+    }
+
+    column.dict = Dictionary<V>(distinct);
+    std::vector<Code> rank(distinct.size());
+    for (Code id = 0; id < distinct.size(); id++) rank[id] = column.dict.code(distinct[id]);
+    for (Code& c : column.codes) c = rank[c];
+    return column;
+}
+
+/**
+ * @brief Codes for the lexicographic (first, second) order, in row order.
+ * @details The result ranges over first.dict.size() * second.dict.size() buckets.
+ */
+template <class A, class B>
+std::vector<Code> combineCodes(const EncodedColumn<A>& first, const EncodedColumn<B>& second) {
+    const Code k2 = (Code)second.dict.size();
+    std::vector<Code> codes(first.codes.size());
+    for (std::size_t i = 0; i < codes.size(); i++)
+        codes[i] = first.codes[i] * k2 + second.codes[i];
+    return codes;
+}
+
+/**
+ * @brief Stable counting sort of `data` by the aligned code column `codes` (codes < k).
+ * @details One pass counts the codes, a prefix sum turns the counts into
+ *          bucket starts and one pass scatters rows (and their codes) into an
+ *          auxiliary buffer. Counts one assignment per row placed and one
+ *          allocation for the buffer; there are no comparisons.
+ * @param arena Optional caller-owned row buffer, reused across calls.
+ */
+template <class T, class Policy = NoCount>
+void countingSort(std::vector<T>& data, std::vector<Code>& codes, std::size_t k,
+                  const Policy& p = Policy(), std::vector<T>* arena = nullptr) {
+    const std::size_t n = data.size();
+    if (n < 2) return;
+
+    std::vector<std::size_t> start(k + 1, 0);
+    for (Code c : codes) start[c + 1]++;
+    for (std::size_t b = 0; b < k; b++) start[b + 1] += start[b];
+
+    std::vector<T> local;
+    std::vector<T>& buffer = arena ? *arena : local;
+    prepareBuffer(buffer, n, p);
+    std::vector<Code> sortedCodes(n);
+    for (std::size_t i = 0; i < n; i++) {
+        std::size_t at = start[codes[i]]++;
+        buffer[at] = std::move(data[i]);
+        sortedCodes[at] = codes[i];
+        p.assign();
+    }
+    data.swap(buffer);
+    codes.swap(sortedCodes);
+}
+
+} // namespace sorting
+
+#endif // DAA_DICTIONARY_HPP
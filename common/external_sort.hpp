@@ -0,0 +1,436 @@
+/**
+ * @file external_sort.hpp
+ * @brief External (out-of-core) merge sort of CSV files larger than memory
+ * @details The loaders read a whole CSV into one vector, which caps the input
+ *          at the size of RAM. The external sort streams the input instead:
+ *
+ *          1. Run formation: rows are parsed block by block into a run of at
+ *             most `runRows(config)` records. Each full run is stably sorted
+ *             (mergeSortBuffered, caller-owned arena) and spilled to a temporary
+ *             file as raw records, which is smaller than the CSV text.
+ *          2. Merging: runs are k-way merged with a loser tree, ties going to
+ *             the earlier run, so the result is the same stable order as an
+ *             in-memory merge sort. If there are more runs than the budget
+ *             allows readers for, consecutive groups are merged into longer
+ *             runs first (one extra pass each time).
+ *
+ *          Reads go through a pair of blocks: while one is parsed, the next
+ *          is read on a background thread. Writes go through csv::Writer with
+ *          its background thread. The budget covers the run, its merge buffer
+ *          and all IO blocks. Input that fits in a single run is sorted and written
+ *          without touching the spill directory.
+ */
+
+#ifndef DAA_EXTERNAL_SORT_HPP
+#define DAA_EXTERNAL_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "csv_mmap.hpp"
+#include "csv_writer.hpp"
+#include "customer.hpp"
+#include "sorting.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace external {
+
+/**
+ * @struct Config
+ * @brief Memory budget and spill location of one external sort.
+ */
+struct Config {
+    std::size_t memoryBytes = std::size_t(64) << 20; ///< Run, merge buffer and IO blocks together.
+    std::size_t blockBytes = std::size_t(1) << 20;   ///< Upper bound on one IO block.
+    std::string spillDir;                             ///< Empty: the system temporary directory.
+};
+
+/**
+ * @struct Stats
+ * @brief What one external sort did.
+ */
+struct Stats {
+    std::size_t rows = 0;
+    std::size_t skipped = 0;      ///< Data lines `parse` rejected.
+    std::size_t runs = 0;         ///< Sorted runs formed from the input (1 means no spill).
+    std::size_t mergePasses = 0;  ///< Intermediate passes before the final merge.
+    std::size_t fanIn = 0;        ///< Most runs merged at once.
+    std::size_t bytesRead = 0;    ///< Input CSV bytes.
+    std::size_t bytesSpilled = 0; ///< Bytes written to run files, over all passes.
+    std::size_t bytesWritten = 0; ///< Output CSV bytes.
+    long peakRssKb = -1;          ///< Process peak resident set size, -1 if unknown.
+    double seconds = 0;
+};
+
+/// @brief Peak resident set size of this process in KiB, or -1 if unavailable.
+inline long peakRssKb() {
+#if defined(__unix__) || defined(__APPLE__)
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#if defined(__APPLE__)
+    return (long)(usage.ru_maxrss / 1024); // bytes on macOS
+#else
+    return (long)usage.ru_maxrss;
+#endif
+#else
+    return -1;
+#endif
+}
+
+/// @brief IO block size for `config`: small enough that the merge keeps a fan-in of at least 7.
+inline std::size_t blockSize(const Config& config, std::size_t record) {
+    std::size_t block = std::min(config.blockBytes, config.memoryBytes / 16);
+    block -= block % record;
+    return std::max(block, record * 64);
+}
+
+/// @brief Records per run: the run and its merge buffer share what the IO blocks leave.
+template <class T>
+std::size_t runRows(const Config& config) {
+    std::size_t io = (2 + csv::WRITE_BUFFERS) * blockSize(config, sizeof(T));
+    std::size_t left = config.memoryBytes > io ? config.memoryBytes - io : 0;
+    return std::max<std::size_t>(left / (2 * sizeof(T)), 1024);
+}
+
+/**
+ * @class BlockReader
+ * @brief Reads a file in blocks, the next block being read while the current one is used.
+ */
+class BlockReader {
+public:
+    BlockReader(const std::string& path, std::size_t blockBytes) : file(std::fopen(path.c_str(), "rb")) {
+        if (!file) return;
+        buffers[0].resize(blockBytes);
+        buffers[1].resize(blockBytes);
+        prefetch();
+    }
+
+    ~BlockReader() {
+        if (pending.valid()) pending.wait();
+        if (file) std::fclose(file);
+    }
+
+    BlockReader(const BlockReader&) = delete;
+    BlockReader& operator=(const BlockReader&) = delete;
+
+    /// @brief false if the file did not open or a read failed (check once next() returned empty).
+    bool ok() const { return file != nullptr && !failed; }
+
+    /// @brief The next block (valid until the following call); empty at end of file or on error.
+    std::string_view next() {
+        if (!pending.valid()) return std::string_view();
+        std::size_t n = pending.get();
+        const char* data = buffers[fill].data();
+        fill ^= 1;
+        if (n > 0) prefetch();
+        return std::string_view(data, n);
+    }
+
+private:
+    std::FILE* file;
+    std::vector<char> buffers[2];
+    int fill = 0; ///< Buffer the pending read goes into.
+    std::future<std::size_t> pending;
+    bool failed = false; ///< Set by the pending read; seen after pending.get().
+
+    void prefetch() {
+        pending = std::async(std::launch::async, [this, b = fill] {
+            std::size_t n = std::fread(buffers[b].data(), 1, buffers[b].size(), file);
+            if (n < buffers[b].size() && std::ferror(file)) failed = true;
+            return n;
+        });
+    }
+};
+
+/**
+ * @brief Calls `fn(line)` for every non-empty line of the file behind `reader`.
+ * @details Lines split across blocks are joined in a small carry string.
+ * @return Bytes read.
+ */
+template <class Fn>
+std::size_t forEachLine(BlockReader& reader, Fn fn) {
+    std::string carry;
+    std::size_t bytes = 0;
+    for (std::string_view block = reader.next(); !block.empty(); block = reader.next()) {
+        bytes += block.size();
+        std::size_t last = block.rfind('\n');
+        if (last == std::string_view::npos) {
+            carry.append(block);
+            continue;
+        }
+        std::size_t from = 0;
+        if (!carry.empty()) {
+            from = block.find('\n') + 1;
+            carry.append(block.substr(0, from));
+            csv::forEachLine(carry, fn);
+            carry.clear();
+        }
+        csv::forEachLine(block.substr(from, last + 1 - from), fn);
+        carry.assign(block.substr(last + 1));
+    }
+    csv::forEachLine(carry, fn);
+    return bytes;
+}
+
+/**
+ * @class RunReader
+ * @brief Sequential reader of a spilled run of trivially copyable records.
+ */
+template <class T>
+class RunReader {
+public:
+    RunReader(const std::string& path, std::size_t blockBytes) : reader(path, blockBytes) { advance(); }
+
+    /// @brief Current record, or nullptr once the run is exhausted.
+    const T* head() const { return valid ? &current : nullptr; }
+
+    /// @brief false if the run did not open, a read failed or it ended inside a record.
+    bool ok() const { return reader.ok() && !truncated; }
+
+    void advance() {
+        if (at >= block.size()) {
+            block = reader.next(); // whole records: blocks are multiples of sizeof(T)
+            at = 0;
+            if (block.size() % sizeof(T) != 0) {
+                truncated = true;
+                block = std::string_view();
+            }
+        }
+        valid = at < block.size();
+        if (valid) std::memcpy(&current, block.data() + at, sizeof(T));
+        at += sizeof(T);
+    }
+
+private:
+    BlockReader reader;
+    std::string_view block;
+    std::size_t at = 0;
+    T current;
+    bool valid = false;
+    bool truncated = false;
+};
+
+/**
+ * @class LoserTree
+ * @brief Tournament tree over k sorted sources; each pop costs about log2(k) comparisons.
+ * @details Internal node i (1 <= i < k) keeps the source that lost the match
+ *          played there; slot 0 keeps the overall winner. Leaf j sits at
+ *          position k + j. Equal keys go to the lower source index, which keeps
+ *          a merge of consecutive runs stable.
+ */
+template <class T, class K>
+class LoserTree {
+public:
+    /// @param heads First record of every source (nullptr: source empty).
+    LoserTree(std::vector<const T*> heads, const K& key)
+        : k(heads.size()), heads(std::move(heads)), tree(std::max<std::size_t>(k, 1)), key(key) {
+        if (k > 0) tree[0] = build(1);
+    }
+
+    /// @brief Source holding the smallest head, or -1 when every source is exhausted.
+    std::ptrdiff_t winner() const {
+        return k > 0 && heads[tree[0]] ? (std::ptrdiff_t)tree[0] : -1;
+    }
+
+    /// @brief Replaces the winner's head with `next` (nullptr: exhausted) and replays its path.
+    void replace(const T* next) {
+        std::size_t w = tree[0];
+        heads[w] = next;
+        for (std::size_t node = (w + k) / 2; node >= 1; node /= 2)
+            if (beats(tree[node], w)) std::swap(tree[node], w);
+        tree[0] = w;
+    }
+
+private:
+    std::size_t k;
+    std::vector<const T*> heads;
+    std::vector<std::size_t> tree;
+    const K& key;
+
+    bool beats(std::size_t a, std::size_t b) const {
+        if (!heads[a]) return false;
+        if (!heads[b]) return true;
+        int c = key.compare(*heads[a], *heads[b], sorting::NoCount());
+        return c < 0 || (c == 0 && a < b);
+    }
+
+    std::size_t build(std::size_t node) {
+        if (node >= k) return node - k;
+        std::size_t a = build(2 * node), b = build(2 * node + 1);
+        if (beats(a, b)) std::swap(a, b);
+        tree[node] = a; // loser stays, winner moves up
+        return b;
+    }
+};
+
+/**
+ * @brief Merges the run files `paths` in order, calling `emit(record)` for every record.
+ * @return false if a run could not be opened or read to its end; nothing is emitted
+ *         when one fails to open.
+ */
+template <class T, class K, class Emit>
+bool mergeRuns(const std::vector<std::string>& paths, std::size_t blockBytes, const K& key, Emit emit) {
+    std::vector<std::unique_ptr<RunReader<T>>> readers;
+    std::vector<const T*> heads;
+    for (const std::string& path : paths) {
+        readers.push_back(std::make_unique<RunReader<T>>(path, blockBytes));
+        if (!readers.back()->ok()) return false;
+        heads.push_back(readers.back()->head());
+    }
+    LoserTree<T, K> tree(heads, key);
+    for (std::ptrdiff_t w = tree.winner(); w >= 0; w = tree.winner()) {
+        emit(*readers[w]->head());
+        readers[w]->advance();
+        tree.replace(readers[w]->head());
+    }
+    for (const auto& reader : readers)
+        if (!reader->ok()) return false;
+    return true;
+}
+
+/**
+ * @brief Externally sorts the CSV at `input` into `output` (same header) by `key`.
+ * @param parse `bool(std::string_view line, T&)`; rows it rejects are skipped.
+ * @param format `char*(const T&, char* at)` writing one line of at most `maxLine` bytes.
+ * @return false if a file could not be opened, read or written.
+ */
+template <class T, class K, class Parse, class Format>
+bool sortCsv(const std::string& input, const std::string& output, std::string_view header,
+             Parse parse, Format format, std::size_t maxLine, const K& key, const Config& config,
+             Stats* stats = nullptr) {
+    static_assert(std::is_trivially_copyable<T>::value, "runs are spilled as raw records");
+    csv::Stopwatch clock;
+    Stats local;
+    Stats& s = stats ? *stats : local;
+    s = Stats();
+
+    const std::size_t block = blockSize(config, sizeof(T));
+    const std::size_t capacity = runRows<T>(config);
+    const std::string dir = config.spillDir.empty() ? std::filesystem::temp_directory_path().string()
+                                                    : config.spillDir;
+#if defined(__unix__) || defined(__APPLE__)
+    const std::string prefix = dir + "/daa_run_" + std::to_string((long)getpid()) + "_";
+#else
+    const std::string prefix = dir + "/daa_run_";
+#endif
+    std::size_t nextFile = 0;
+    std::vector<std::string> runs;
+    bool ok = true;
+
+    auto spill = [&](auto writeAll) {
+        std::string path = prefix + std::to_string(nextFile++) + ".bin";
+        csv::Writer out(path, block, true);
+        writeAll(out);
+        ok &= out.finish();
+        s.bytesSpilled += out.bytes();
+        return path;
+    };
+    auto removeAll = [](const std::vector<std::string>& paths) {
+        for (const std::string& path : paths) std::remove(path.c_str());
+    };
+
+    // Run formation
+    std::vector<T> run, arena;
+    run.reserve(capacity);
+    arena.reserve(capacity);
+    {
+        BlockReader in(input, block);
+        if (!in.ok()) return false;
+        bool first = true;
+        s.bytesRead = forEachLine(in, [&](std::string_view line) {
+            if (first) { // header
+                first = false;
+                return;
+            }
+            T item;
+            if (!parse(line, item)) {
+                s.skipped++;
+                return;
+            }
+            s.rows++;
+            run.push_back(item);
+            if (run.size() == capacity) {
+                sorting::mergeSortBuffered(run, key, sorting::NoCount(), &arena);
+                runs.push_back(spill([&](csv::Writer& out) { out.write(run.data(), run.size() * sizeof(T)); }));
+                run.clear();
+            }
+        });
+        ok &= in.ok();
+    }
+    sorting::mergeSortBuffered(run, key, sorting::NoCount(), &arena);
+    s.runs = runs.size() + (run.empty() && !runs.empty() ? 0 : 1);
+
+    csv::Writer out(output, block, true);
+    auto writeCsv = [&](const T& item) { out.append(maxLine, [&](char* at) { return format(item, at); }); };
+    out.write(header.data(), header.size());
+    out.write("\n", 1);
+
+    if (runs.empty()) {
+        // Everything fit in memory: no spill
+        for (const T& item : run) writeCsv(item);
+    } else {
+        if (!run.empty())
+            runs.push_back(spill([&](csv::Writer& w) { w.write(run.data(), run.size() * sizeof(T)); }));
+        std::vector<T>().swap(run);
+        std::vector<T>().swap(arena);
+
+        // Fan-in: every reader holds two blocks, plus the writer's buffers
+        const std::size_t blocks = config.memoryBytes / block;
+        const std::size_t fanIn = std::max<std::size_t>(2, blocks > csv::WRITE_BUFFERS ? (blocks - csv::WRITE_BUFFERS) / 2 : 0);
+        while (runs.size() > fanIn) {
+            std::vector<std::string> merged;
+            for (std::size_t g = 0; g < runs.size(); g += fanIn) {
+                std::vector<std::string> group(runs.begin() + g, runs.begin() + std::min(runs.size(), g + fanIn));
+                if (group.size() == 1) {
+                    merged.push_back(group[0]);
+                    continue;
+                }
+                merged.push_back(spill([&](csv::Writer& w) {
+                    ok &= mergeRuns<T>(group, block, key, [&](const T& item) { w.write(&item, sizeof(T)); });
+                }));
+                removeAll(group);
+            }
+            runs.swap(merged);
+            s.mergePasses++;
+            s.fanIn = fanIn;
+        }
+        s.fanIn = std::max(s.fanIn, runs.size());
+        ok &= mergeRuns<T>(runs, block, key, writeCsv);
+        removeAll(runs);
+    }
+
+    ok &= out.finish();
+    s.bytesWritten = out.bytes();
+    s.peakRssKb = peakRssKb();
+    s.seconds = clock.seconds();
+    return ok;
+}
+
+/**
+ * @brief Externally sorts a bank CSV by estimated salary (stable, like the in-memory merge sort).
+ */
+inline bool sortBankCsv(const std::string& input, const std::string& output, const Config& config,
+                        Stats* stats = nullptr) {
+    return sortCsv<bank::Customer>(
+        input, output, bank::HEADER, [](std::string_view line, bank::Customer& c) { return bank::parseLine(line, c); },
+        [](const bank::Customer& c, char* at) { return bank::formatLine(c, at); }, bank::MAX_LINE,
+        sorting::Key<sorting::Field<&bank::Customer::salary>>(), config, stats);
+}
+
+} // namespace external
+
+#endif // DAA_EXTERNAL_SORT_HPP
@@ -0,0 +1,222 @@
+/**
+ * @file generators.hpp
+ * @brief Input distributions ("shapes") for the benchmark generators
+ * @details The generators used to draw every element uniformly from a pool
+ *          (names and ages, or rows of the bank data), so every benchmark saw
+ *          random order. The sorts differ most on other inputs: insertion
+ *          sort is linear on sorted data and quadratic on reversed data,
+ *          Lomuto quick sort with the last pivot is quadratic on both and on
+ *          equal keys, and merge sort barely notices. A shape is built in two
+ *          steps:
+ *
+ *              draw     n elements from the caller's pool, by uniform or
+ *                       Zipf-skewed indices (all_equal draws once);
+ *              arrange  them by the sort key: sorted, reversed, a few swaps, ...
+ *
+ *          so one table covers Record, Customer or any other element type.
+ *          Both steps take all randomness from the caller's generator, so a
+ *          sweep cell's input depends only on its seed.
+ */
+
+#ifndef DAA_GENERATORS_HPP
+#define DAA_GENERATORS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "sorting.hpp"
+
+namespace gen {
+
+/**
+ * @enum Shape
+ * @brief Input distributions; SHAPES holds their names.
+ */
+enum class Shape {
+    Uniform,      ///< Uniform draws in draw order (the original generators).
+    Sorted,       ///< Uniform draws in key order.
+    Reversed,     ///< Uniform draws in reverse key order.
+    NearlySorted, ///< Sorted, then `swapFraction` * n random pairs swapped.
+    Appended,     ///< Sorted with `swapFraction` of the rows moved to the end, shuffled.
+    Sawtooth,     ///< `teeth` ascending runs, each spanning the whole key range.
+    OrganPipe,    ///< Ascending to the largest key, then descending.
+    Zipf,         ///< Pool index k drawn with probability proportional to 1 / k^zipfExponent.
+    AllEqual      ///< One draw repeated n times.
+};
+
+/**
+ * @struct ShapeInfo
+ * @brief A Shape with its command-line name.
+ */
+struct ShapeInfo {
+    Shape shape;
+    const char* name;
+};
+
+inline constexpr ShapeInfo SHAPES[] = {
+    {Shape::Uniform, "uniform"},       {Shape::Sorted, "sorted"},
+    {Shape::Reversed, "reversed"},     {Shape::NearlySorted, "nearly_sorted"},
+    {Shape::Appended, "appended"},     {Shape::Sawtooth, "sawtooth"},
+    {Shape::OrganPipe, "organ_pipe"},  {Shape::Zipf, "zipf"},
+    {Shape::AllEqual, "all_equal"}};
+
+/// @brief The name of `shape` in SHAPES.
+inline const char* name(Shape shape) {
+    for (const ShapeInfo& s : SHAPES)
+        if (s.shape == shape) return s.name;
+    return "uniform";
+}
+
+/// @brief The SHAPES entry called `name`, or nullptr.
+inline const ShapeInfo* findShape(std::string_view name) {
+    for (const ShapeInfo& s : SHAPES)
+        if (name == s.name) return &s;
+    return nullptr;
+}
+
+/// @brief "uniform, sorted, ..." for error messages.
+inline std::string shapeNames() {
+    std::string out;
+    for (const ShapeInfo& s : SHAPES) out += (out.empty() ? "" : ", ") + std::string(s.name);
+    return out;
+}
+
+/**
+ * @struct Params
+ * @brief Tuning of the shapes that have one.
+ */
+struct Params {
+    double swapFraction = 0.01; ///< nearly_sorted swaps and appended rows, as a fraction of n (at least 1).
+    std::size_t teeth = 8;      ///< Runs of sawtooth (at most n).
+    double zipfExponent = 1.0;  ///< Skew of zipf; larger puts more draws on the first pool entries.
+};
+
+/**
+ * @class Picker
+ * @brief Pool indices for a draw function: uniform, or Zipf-skewed.
+ * @details Uniform indices are `rng() % count`, as the original generators
+ *          drew them, so uniform data are unchanged for a given seed. Zipf
+ *          keeps the cumulative weights of the last pool size it saw and
+ *          picks by binary search.
+ */
+class Picker {
+public:
+    /// @param zipfExponent 0 for uniform indices.
+    explicit Picker(std::mt19937& rng, double zipfExponent = 0) : rng(rng), exponent(zipfExponent) {}
+
+    /// @brief An index in [0, count); count must be positive.
+    std::size_t operator()(std::size_t count) {
+        if (exponent <= 0) return rng() % count;
+        if (cumulative.size() != count) {
+            cumulative.resize(count);
+            double sum = 0;
+            for (std::size_t k = 0; k < count; k++) cumulative[k] = sum += 1.0 / std::pow((double)(k + 1), exponent);
+        }
+        double u = std::uniform_real_distribution<double>(0, cumulative.back())(rng);
+        std::size_t k = std::upper_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin();
+        return std::min(k, count - 1);
+    }
+
+private:
+    std::mt19937& rng;
+    double exponent;
+    std::vector<double> cumulative;
+};
+
+/**
+ * @brief Draws the n elements of `shape` in draw order (before arrange()).
+ * @param draw Called as `draw(Picker&)` for one element; it picks pool indices through the Picker.
+ */
+template <class T, class Draw>
+std::vector<T> draw(Shape shape, std::size_t n, std::mt19937& rng, Draw draw, const Params& params = Params()) {
+    Picker pick(rng, shape == Shape::Zipf ? params.zipfExponent : 0);
+    std::vector<T> data;
+    if (n == 0) return data;
+    if (shape == Shape::AllEqual) {
+        data.assign(n, draw(pick));
+        return data;
+    }
+    data.reserve(n);
+    for (std::size_t i = 0; i < n; i++) data.push_back(draw(pick));
+    return data;
+}
+
+/**
+ * @brief Puts drawn elements in the order of `shape` under `key` (uniform, zipf and all_equal keep theirs).
+ * @details Sorting is stable (sorting::mergeSortBuffered, uncounted), so equal keys
+ *          keep their draw order.
+ */
+template <class T, class K>
+void arrange(std::vector<T>& data, Shape shape, const K& key, std::mt19937& rng, const Params& params = Params()) {
+    const std::size_t n = data.size();
+    if (n < 2 || shape == Shape::Uniform || shape == Shape::Zipf || shape == Shape::AllEqual) return;
+
+    if (shape == Shape::Sawtooth) {
+        const std::size_t teeth = std::clamp<std::size_t>(params.teeth, 1, n);
+        for (std::size_t t = 0; t < teeth; t++) {
+            std::vector<T> tooth(std::make_move_iterator(data.begin() + n * t / teeth),
+                                 std::make_move_iterator(data.begin() + n * (t + 1) / teeth));
+            sorting::mergeSortBuffered(tooth, key);
+            std::move(tooth.begin(), tooth.end(), data.begin() + n * t / teeth);
+        }
+        return;
+    }
+
+    sorting::mergeSortBuffered(data, key);
+    const std::size_t few = std::max<std::size_t>(1, (std::size_t)(n * params.swapFraction));
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+
+    switch (shape) {
+        case Shape::Reversed:
+            std::reverse(data.begin(), data.end());
+            break;
+        case Shape::NearlySorted:
+            for (std::size_t s = 0; s < few; s++) std::swap(data[pick(rng)], data[pick(rng)]);
+            break;
+        case Shape::Appended: {
+            // A table sorted by yesterday's run with a few rows taken out and re-appended
+            std::vector<char> moved(n, 0);
+            for (std::size_t s = 0; s < few; s++) moved[pick(rng)] = 1;
+            std::vector<T> kept, tail;
+            kept.reserve(n);
+            for (std::size_t i = 0; i < n; i++) (moved[i] ? tail : kept).push_back(std::move(data[i]));
+            std::shuffle(tail.begin(), tail.end(), rng);
+            std::move(tail.begin(), tail.end(), std::back_inserter(kept));
+            data = std::move(kept);
+            break;
+        }
+        case Shape::OrganPipe: {
+            // Even ranks ascending, then odd ranks descending
+            std::vector<T> pipe;
+            pipe.reserve(n);
+            for (std::size_t i = 0; i < n; i += 2) pipe.push_back(std::move(data[i]));
+            for (std::size_t i = n - 1 - n % 2; i < n; i -= 2) pipe.push_back(std::move(data[i]));
+            data = std::move(pipe);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief draw() then arrange(): n elements of `shape`, ordered under `key`.
+ */
+template <class T, class Draw, class K>
+std::vector<T> generate(Shape shape, std::size_t n, std::mt19937& rng, Draw drawOne, const K& key,
+                        const Params& params = Params()) {
+    std::vector<T> data = draw<T>(shape, n, rng, drawOne, params);
+    arrange(data, shape, key, rng, params);
+    return data;
+}
+
+} // namespace gen
+
+#endif // DAA_GENERATORS_HPP
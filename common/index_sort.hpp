@@ -0,0 +1,68 @@
+/**
+ * @file index_sort.hpp
+ * @brief Permutation ("index") sorting of wide records
+ * @details Instead of moving whole records, sort a compact (key, row) vector
+ *          with any algorithm from sorting.hpp and visit the rows in the
+ *          resulting order once, at output time. Ties keep row order with the
+ *          stable sorts, and every algorithm takes the same decisions as on the
+ *          full records (they only look at keys), so the output is identical.
+ */
+
+#ifndef DAA_INDEX_SORT_HPP
+#define DAA_INDEX_SORT_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "sorting.hpp"
+
+namespace sorting {
+
+/**
+ * @struct Keyed
+ * @brief A copied sort key plus the row it came from.
+ */
+template <class K>
+struct Keyed {
+    K key;
+    std::uint32_t index;
+};
+
+/// Orders Keyed<K> entries by their key.
+template <class K>
+using ByKeyed = Key<Field<&Keyed<K>::key>>;
+
+/**
+ * @brief Builds the (key, row) vector for `rows` in their current order.
+ * @param proj Projection returning the key, e.g. Field<&Customer::salary>().
+ */
+template <class T, class Proj>
+auto makeIndex(const std::vector<T>& rows, Proj proj) {
+    using K = std::decay_t<decltype(proj(rows[0]))>;
+    std::vector<Keyed<K>> order(rows.size());
+    for (std::size_t i = 0; i < rows.size(); i++)
+        order[i] = Keyed<K>{proj(rows[i]), (std::uint32_t)i};
+    return order;
+}
+
+/// @brief Calls `fn(row)` for every row in the order given by `order`.
+template <class T, class K, class Fn>
+void forEachInOrder(const std::vector<T>& rows, const std::vector<Keyed<K>>& order, Fn fn) {
+    for (const auto& k : order)
+        fn(rows[k.index]);
+}
+
+/// @brief Materialises a reordered copy (only when a caller really needs one).
+template <class T, class K>
+std::vector<T> gather(const std::vector<T>& rows, const std::vector<Keyed<K>>& order) {
+    std::vector<T> out;
+    out.reserve(order.size());
+    for (const auto& k : order)
+        out.push_back(rows[k.index]);
+    return out;
+}
+
+} // namespace sorting
+
+#endif // DAA_INDEX_SORT_HPP
@@ -0,0 +1,311 @@
+/**
+ * @file parallel_sort.hpp
+ * @brief Multi-core sorts built on the work-stealing pool
+ * @details The parallel sorts take the same Key types as sorting.hpp but are
+ *          always uncounted (the global counters are not thread-safe); use the
+ *          serial sorts with CountOps for operation counts.
+ *
+ *          parallelMergeSort is stable: halves above `cutoff` are forked as
+ *          tasks, and large merges are split into independent pieces by
+ *          binary-searching co-ranks, so the top-level merge is not serial.
+ *
+ *          parallelQuickSort is an introsort: ninther pivots, and ranges that
+ *          outlive 2 log2(n) partition levels are heap sorted, so inputs that
+ *          defeat a fixed median-of-3 (appended sorted runs, organ pipes) stay
+ *          O(n log n). It forks the smaller side of every partition above `cutoff`.
+ *          At the top levels, where one serial pass over millions of rows would
+ *          dominate, the partition itself is block-parallel: blocks count their
+ *          elements per side, a prefix sum assigns output offsets, and every
+ *          block scatters into a scratch buffer independently. Partitions are
+ *          three-way (<, ==, > pivot), so duplicate-heavy keys shrink quickly.
+ */
+
+#ifndef DAA_PARALLEL_SORT_HPP
+#define DAA_PARALLEL_SORT_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "sorting.hpp"
+#include "thread_pool.hpp"
+
+namespace parallel {
+
+/// @brief Strict "a before b" for a sorting.hpp key, uncounted.
+template <class K, class T>
+bool less(const K& key, const T& a, const T& b) {
+    return key.compare(a, b, sorting::NoCount()) < 0;
+}
+
+/// @brief Stable insertion sort of a[0..n) for short ranges.
+template <class T, class K>
+void insertionSortRange(T* a, std::size_t n, const K& key) {
+    for (std::size_t i = 1; i < n; i++) {
+        T item = std::move(a[i]);
+        std::size_t j = i;
+        for (; j > 0 && less(key, item, a[j - 1]); j--) a[j] = std::move(a[j - 1]);
+        a[j] = std::move(item);
+    }
+}
+
+/**
+ * @brief Co-rank of output position `k` when stably merging a[0..na) and b[0..nb).
+ * @return i such that the first k outputs are a[0..i) and b[0..k-i).
+ *         Ties go to `a`, which keeps the merge stable.
+ */
+template <class T, class K>
+std::size_t coRank(std::size_t k, const T* a, std::size_t na, const T* b, std::size_t nb, const K& key) {
+    std::size_t lo = k > nb ? k - nb : 0;
+    std::size_t hi = std::min(k, na);
+    while (lo < hi) {
+        std::size_t i = lo + (hi - lo) / 2;
+        std::size_t j = k - i;
+        if (j > 0 && i < na && !less(key, b[j - 1], a[i]))
+            lo = i + 1; // a[i] must still be among the first k
+        else if (i > 0 && j < nb && less(key, b[j], a[i - 1]))
+            hi = i - 1; // a[i-1] must come after b[j]
+        else
+            return i;
+    }
+    return lo;
+}
+
+/// @brief Serial stable merge of a[0..na) and b[0..nb) into out (elements are moved).
+template <class T, class K>
+void mergeRuns(T* a, std::size_t na, T* b, std::size_t nb, T* out, const K& key) {
+    std::size_t i = 0, j = 0;
+    while (i < na && j < nb)
+        *out++ = less(key, b[j], a[i]) ? std::move(b[j++]) : std::move(a[i++]);
+    while (i < na) *out++ = std::move(a[i++]);
+    while (j < nb) *out++ = std::move(b[j++]);
+}
+
+/**
+ * @brief Stable merge of two runs, split into `pieces` co-ranked chunks run as tasks.
+ */
+template <class T, class K>
+void parallelMerge(T* a, std::size_t na, T* b, std::size_t nb, T* out, const K& key,
+                   ThreadPool& pool, std::size_t cutoff) {
+    const std::size_t n = na + nb;
+    std::size_t pieces = std::min<std::size_t>(pool.size() * 4, n / cutoff + 1);
+    if (pieces <= 1) {
+        mergeRuns(a, na, b, nb, out, key);
+        return;
+    }
+    // All split points first: the merges move elements out of a and b
+    std::vector<std::size_t> k(pieces + 1), i(pieces + 1);
+    for (std::size_t p = 0; p <= pieces; p++) {
+        k[p] = n * p / pieces;
+        i[p] = coRank(k[p], a, na, b, nb, key);
+    }
+    TaskGroup group(pool);
+    for (std::size_t p = 0; p < pieces; p++) {
+        std::size_t ai = i[p], an = i[p + 1] - i[p];
+        std::size_t bj = k[p] - i[p], bn = (k[p + 1] - i[p + 1]) - bj;
+        T* to = out + k[p];
+        group.run([=, &key] { mergeRuns(a + ai, an, b + bj, bn, to, key); });
+    }
+    group.wait();
+}
+
+/**
+ * @brief Sorts src[0..n); the result ends up in dst if `intoDst`, else in src.
+ * @details The other array is scratch; the two buffers ping-pong between levels.
+ */
+template <class T, class K>
+void mergeSortTo(T* src, T* dst, std::size_t n, bool intoDst, const K& key,
+                 ThreadPool& pool, std::size_t cutoff) {
+    if (n <= 16) {
+        // Short runs: stable insertion sort in place, then copy if needed
+        insertionSortRange(src, n, key);
+        if (intoDst) std::move(src, src + n, dst);
+        return;
+    }
+
+    const std::size_t half = n / 2;
+    if (n > cutoff) {
+        TaskGroup group(pool);
+        group.run([=, &key, &pool] { mergeSortTo(src, dst, half, !intoDst, key, pool, cutoff); });
+        mergeSortTo(src + half, dst + half, n - half, !intoDst, key, pool, cutoff);
+        group.wait();
+    } else {
+        mergeSortTo(src, dst, half, !intoDst, key, pool, cutoff);
+        mergeSortTo(src + half, dst + half, n - half, !intoDst, key, pool, cutoff);
+    }
+
+    T* from = intoDst ? src : dst;
+    T* to = intoDst ? dst : src;
+    parallelMerge(from, half, from + half, n - half, to, key, pool, cutoff);
+}
+
+/**
+ * @brief Stable parallel merge sort of the whole vector.
+ * @param cutoff Ranges of at most this many elements are sorted/merged serially.
+ */
+template <class T, class K>
+void parallelMergeSort(std::vector<T>& data, const K& key, ThreadPool& pool,
+                       std::size_t cutoff = 8192) {
+    if (data.size() < 2) return;
+    std::vector<T> buffer(data.size());
+    mergeSortTo(data.data(), buffer.data(), data.size(), false, key, pool, std::max<std::size_t>(cutoff, 32));
+}
+
+/**
+ * @brief Stable block-parallel partition of a[0..n) by `pred`.
+ * @details Count, prefix-sum and scatter into `scratch` run block by block as
+ *          tasks; the result is then moved back into `a`.
+ * @return Number of elements for which `pred` holds (they come first).
+ */
+template <class T, class Pred>
+std::size_t blockPartition(T* a, T* scratch, std::size_t n, Pred pred, ThreadPool& pool) {
+    const std::size_t blocks = std::max<std::size_t>(1, std::min<std::size_t>(pool.size() * 4, n / 4096));
+    auto begin = [&](std::size_t b) { return n * b / blocks; };
+    std::vector<std::size_t> trues(blocks);
+
+    TaskGroup group(pool);
+    for (std::size_t b = 0; b < blocks; b++)
+        group.run([&, b] {
+            std::size_t c = 0;
+            for (std::size_t x = begin(b); x < begin(b + 1); x++) c += pred(a[x]) ? 1 : 0;
+            trues[b] = c;
+        });
+    group.wait();
+
+    std::vector<std::size_t> trueAt(blocks), falseAt(blocks);
+    std::size_t totalTrue = 0;
+    for (std::size_t b = 0; b < blocks; b++) {
+        trueAt[b] = totalTrue;
+        totalTrue += trues[b];
+    }
+    for (std::size_t b = 0; b < blocks; b++)
+        falseAt[b] = totalTrue + (begin(b) - trueAt[b]);
+
+    for (std::size_t b = 0; b < blocks; b++)
+        group.run([&, b] {
+            std::size_t t = trueAt[b], f = falseAt[b];
+            for (std::size_t x = begin(b); x < begin(b + 1); x++)
+                scratch[pred(a[x]) ? t++ : f++] = std::move(a[x]);
+        });
+    group.wait();
+
+    for (std::size_t b = 0; b < blocks; b++)
+        group.run([&, b] { std::move(scratch + begin(b), scratch + begin(b + 1), a + begin(b)); });
+    group.wait();
+    return totalTrue;
+}
+
+/// @brief Heap sort of a[0..n), the introsort fallback (O(n log n) worst case, not stable).
+template <class T, class K>
+void heapSortRange(T* a, std::size_t n, const K& key) {
+    const std::ptrdiff_t m = (std::ptrdiff_t)n;
+    for (std::ptrdiff_t root = m / 2 - 1; root >= 0; root--) sorting::siftDown(a, root, m, key, sorting::NoCount());
+    for (std::ptrdiff_t end = m - 1; end > 0; end--) {
+        std::swap(a[0], a[end]);
+        sorting::siftDown(a, 0, end, key, sorting::NoCount());
+    }
+}
+
+/// @brief The median of *x, *y, *z.
+template <class T, class K>
+const T* medianOf3(const T* x, const T* y, const T* z, const K& key) {
+    if (less(key, *y, *x)) std::swap(x, y);
+    if (less(key, *z, *y)) std::swap(y, z);
+    if (less(key, *y, *x)) std::swap(x, y);
+    return y;
+}
+
+/// @brief Tukey's ninther of a[0..n) (median of three medians of evenly spaced triples).
+template <class T, class K>
+const T* ninther(const T* a, std::size_t n, const K& key) {
+    const std::size_t mid = n / 2;
+    if (n < 40) return medianOf3(&a[0], &a[mid], &a[n - 1], key);
+    const std::size_t s = n / 8;
+    return medianOf3(medianOf3(&a[0], &a[s], &a[2 * s], key), medianOf3(&a[mid - s], &a[mid], &a[mid + s], key),
+                     medianOf3(&a[n - 1 - 2 * s], &a[n - 1 - s], &a[n - 1], key), key);
+}
+
+/**
+ * @brief Introsort of a[0..n): ninther pivot, three-way partitioning and a depth limit.
+ * @details Forks the smaller side of every partition above `cutoff` and loops on
+ *          the larger one, so the stack stays O(log n). A range still unsorted
+ *          after `depthLeft` more levels is heap sorted, as in
+ *          sorting::quickSortWith, which bounds the work at O(n log n) on
+ *          inputs such as concatenated sorted runs or organ pipes.
+ * @param scratch Buffer of n elements for block-parallel partitions (may be null
+ *        when n < partitionMin).
+ */
+template <class T, class K>
+void quickSortRange(T* a, std::size_t n, T* scratch, const K& key, ThreadPool& pool,
+                    std::size_t cutoff, std::size_t partitionMin, int depthLeft) {
+    TaskGroup group(pool);
+    while (n > 16) {
+        if (depthLeft-- == 0) {
+            heapSortRange(a, n, key);
+            return;
+        }
+        const T pivot = *ninther(a, n, key);
+
+        std::size_t lt, gt; // [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot
+        if (n >= partitionMin && pool.size() > 1 && scratch) {
+            lt = blockPartition(a, scratch, n, [&](const T& v) { return less(key, v, pivot); }, pool);
+            gt = lt + blockPartition(a + lt, scratch + lt, n - lt,
+                                     [&](const T& v) { return !less(key, pivot, v); }, pool);
+        } else {
+            // Dijkstra's Dutch national flag partition
+            lt = 0;
+            gt = n;
+            std::size_t i = 0;
+            while (i < gt) {
+                if (less(key, a[i], pivot)) std::swap(a[lt++], a[i++]);
+                else if (less(key, pivot, a[i])) std::swap(a[i], a[--gt]);
+                else i++;
+            }
+        }
+
+        // Smaller side: a task (or a call) of its own; larger side: next iteration
+        T* small = a;
+        T* smallScratch = scratch;
+        std::size_t smallN = lt;
+        if (lt <= n - gt) {
+            a += gt;
+            scratch = scratch ? scratch + gt : nullptr;
+            n -= gt;
+        } else {
+            small = a + gt;
+            smallScratch = scratch ? scratch + gt : nullptr;
+            smallN = n - gt;
+            n = lt;
+        }
+        if (n + smallN > cutoff)
+            group.run([=, &key, &pool] {
+                quickSortRange(small, smallN, smallScratch, key, pool, cutoff, partitionMin, depthLeft);
+            });
+        else
+            quickSortRange(small, smallN, smallScratch, key, pool, cutoff, partitionMin, depthLeft);
+    }
+    insertionSortRange(a, n, key);
+    group.wait();
+}
+
+/**
+ * @brief Parallel quick sort of the whole vector (not stable).
+ * @param cutoff Partitions of at most this many elements are sorted serially.
+ * @param partitionMin Ranges of at least this many elements are partitioned
+ *        block-parallel (needs one scratch buffer the size of the input).
+ */
+template <class T, class K>
+void parallelQuickSort(std::vector<T>& data, const K& key, ThreadPool& pool,
+                       std::size_t cutoff = 8192, std::size_t partitionMin = 1 << 17) {
+    if (data.size() < 2) return;
+    std::vector<T> scratch;
+    if (data.size() >= partitionMin && pool.size() > 1) scratch.resize(data.size());
+    quickSortRange(data.data(), data.size(), scratch.empty() ? nullptr : scratch.data(), key, pool,
+                   std::max<std::size_t>(cutoff, 32), partitionMin, 2 * (int)std::log2((double)data.size()));
+}
+
+} // namespace parallel
+
+#endif // DAA_PARALLEL_SORT_HPP
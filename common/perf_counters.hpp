@@ -0,0 +1,144 @@
+/**
+ * @file perf_counters.hpp
+ * @brief Optional hardware performance counters around a sort call (Linux perf_event_open)
+ * @details Opens cycles, instructions, L1D read misses, LLC misses and branch
+ *          mispredictions for the calling thread (user space only). Events the
+ *          kernel or CPU refuses (no PMU in a VM, perf_event_paranoid, non-Linux
+ *          builds) are reported as "NA" instead of failing the run.
+ *
+ *          Each counter is read with its enabled and running times. When the
+ *          PMU has more events than counters the kernel multiplexes the group:
+ *          a value that ran for part of the interval is scaled by
+ *          enabled / running, and one that never ran is "NA", not 0.
+ */
+
+#ifndef DAA_PERF_COUNTERS_HPP
+#define DAA_PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perf {
+
+/// Counters captured per run, in CSV column order.
+enum Event { CYCLES, INSTRUCTIONS, L1D_MISSES, LLC_MISSES, BRANCH_MISSES, EVENT_COUNT };
+
+/// @brief CSV header fragment matching writeSample().
+inline const char* header() {
+    return "cycles,instructions,l1d_misses,llc_misses,branch_misses";
+}
+
+/**
+ * @struct Sample
+ * @brief One reading of every counter; -1 marks an unavailable event.
+ */
+struct Sample {
+    long long value[EVENT_COUNT] = {-1, -1, -1, -1, -1};
+};
+
+/// @brief Writes the counters comma-separated (no leading comma), "NA" if unavailable.
+inline void writeSample(std::ostream& out, const Sample& s) {
+    for (int e = 0; e < EVENT_COUNT; e++) {
+        if (e) out << ",";
+        if (s.value[e] < 0) out << "NA";
+        else out << s.value[e];
+    }
+}
+
+/**
+ * @class CounterGroup
+ * @brief RAII owner of the perf event file descriptors.
+ */
+class CounterGroup {
+public:
+    CounterGroup() {
+#if defined(__linux__)
+        const std::uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        open(CYCLES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+        open(INSTRUCTIONS, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+        open(L1D_MISSES, PERF_TYPE_HW_CACHE, l1dReadMiss);
+        open(LLC_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        open(BRANCH_MISSES, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+    }
+
+    ~CounterGroup() {
+#if defined(__linux__)
+        for (int e = 0; e < EVENT_COUNT; e++)
+            if (fd[e] >= 0) close(fd[e]);
+#endif
+    }
+
+    CounterGroup(const CounterGroup&) = delete;
+    CounterGroup& operator=(const CounterGroup&) = delete;
+
+    /// @brief True if at least one event could be opened.
+    bool available() const { return leader >= 0; }
+
+    /// @brief Resets and starts every open counter.
+    void start() {
+#if defined(__linux__)
+        if (leader < 0) return;
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    /// @brief Stops the counters and returns their values, scaled if they were multiplexed.
+    Sample stop() {
+        Sample s;
+#if defined(__linux__)
+        if (leader < 0) return s;
+        ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        for (int e = 0; e < EVENT_COUNT; e++) {
+            std::uint64_t v[3] = {0, 0, 0}; // value, time enabled, time running
+            if (fd[e] < 0 || read(fd[e], v, sizeof v) != (ssize_t)sizeof v || v[2] == 0) continue;
+            s.value[e] = v[2] < v[1] ? (long long)((double)v[0] * v[1] / v[2]) : (long long)v[0];
+        }
+#endif
+        return s;
+    }
+
+private:
+    int fd[EVENT_COUNT] = {-1, -1, -1, -1, -1};
+    int leader = -1;
+
+#if defined(__linux__)
+    void open(Event e, std::uint32_t type, std::uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof attr);
+        attr.size = sizeof attr;
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = leader < 0 ? 1 : 0; // members follow the leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        fd[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+        if (fd[e] >= 0 && leader < 0) leader = fd[e];
+    }
+#endif
+};
+
+/**
+ * @brief Runs `fn` once between start() and stop() of `group`.
+ */
+template <class Fn>
+Sample measure(CounterGroup& group, Fn fn) {
+    group.start();
+    fn();
+    return group.stop();
+}
+
+} // namespace perf
+
+#endif // DAA_PERF_COUNTERS_HPP
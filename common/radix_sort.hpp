@@ -0,0 +1,107 @@
+/**
+ * @file radix_sort.hpp
+ * @brief LSD radix sort for float and double keys
+ * @details Floating-point keys are mapped to unsigned integers whose order
+ *          matches the numeric order (flip every bit of negatives, set the sign
+ *          bit of positives), then sorted digit by digit, least significant
+ *          first. Each pass is a histogram prefix sum plus one stable scatter
+ *          into a single auxiliary buffer, so the sort does O(n) work per
+ *          digit, makes no comparisons and is stable like merge sort.
+ *
+ *          Digits are 11 bits (2048 counters fit in L1): 6 passes for double,
+ *          3 for float. All histograms are built in one read pass up front,
+ *          and a pass whose digit is the same for every element is skipped.
+ *
+ *          To carry the row index instead of moving whole records, radix sort
+ *          the (key, row) vector from index_sort.hpp with ByKeyed<double>.
+ */
+
+#ifndef DAA_RADIX_SORT_HPP
+#define DAA_RADIX_SORT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sorting.hpp"
+
+namespace sorting {
+
+/// Bits per LSD digit.
+inline constexpr int RADIX_BITS = 11;
+
+/// @brief Order-preserving unsigned image of a float (-0.0 maps like +0.0).
+inline std::uint32_t orderedBits(float x) {
+    if (x == 0) x = 0;
+    std::uint32_t u;
+    std::memcpy(&u, &x, sizeof u);
+    return (u & 0x80000000u) ? ~u : (u | 0x80000000u);
+}
+
+/// @brief Order-preserving unsigned image of a double (-0.0 maps like +0.0).
+inline std::uint64_t orderedBits(double x) {
+    if (x == 0) x = 0;
+    std::uint64_t u;
+    std::memcpy(&u, &x, sizeof u);
+    return (u & 0x8000000000000000ull) ? ~u : (u | 0x8000000000000000ull);
+}
+
+/**
+ * @brief Stable LSD radix sort of the whole vector by a float or double field.
+ * @details Counts one assignment per element scattered and one allocation for
+ *          the buffer; there are no comparisons to count.
+ * @param key A single-field key, e.g. Key<Field<&Customer::salary>>.
+ * @param arena Optional caller-owned buffer, reused across calls.
+ */
+template <class T, class Proj, class Policy = NoCount>
+void radixSort(std::vector<T>& data, const Key<Proj>& key, const Policy& p = Policy(),
+               std::vector<T>* arena = nullptr) {
+    using V = std::decay_t<decltype(key.proj(std::declval<const T&>()))>;
+    static_assert(std::is_floating_point<V>::value, "radixSort needs a float or double key");
+    using U = decltype(orderedBits(V()));
+    constexpr int PASSES = (int)(sizeof(U) * 8 + RADIX_BITS - 1) / RADIX_BITS;
+    constexpr std::size_t BUCKETS = std::size_t(1) << RADIX_BITS;
+    constexpr U MASK = BUCKETS - 1;
+
+    const std::size_t n = data.size();
+    if (n < 2) return;
+
+    // Every digit's histogram in one read pass
+    std::vector<std::size_t> counts(PASSES * BUCKETS, 0);
+    for (const T& item : data) {
+        U u = orderedBits(key.proj(item));
+        for (int d = 0; d < PASSES; d++)
+            counts[d * BUCKETS + ((u >> (d * RADIX_BITS)) & MASK)]++;
+    }
+
+    std::vector<T> local;
+    std::vector<T>& buffer = arena ? *arena : local;
+    prepareBuffer(buffer, n, p);
+
+    T* src = data.data();
+    T* dst = buffer.data();
+    for (int d = 0; d < PASSES; d++) {
+        std::size_t* c = &counts[d * BUCKETS];
+        const int shift = d * RADIX_BITS;
+        if (c[(orderedBits(key.proj(src[0])) >> shift) & MASK] == n) continue; // digit is constant
+
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b < BUCKETS; b++) {
+            std::size_t k = c[b];
+            c[b] = sum;
+            sum += k;
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            dst[c[(orderedBits(key.proj(src[i])) >> shift) & MASK]++] = std::move(src[i]);
+            p.assign();
+        }
+        std::swap(src, dst);
+    }
+    if (src != data.data()) data.swap(buffer);
+}
+
+} // namespace sorting
+
+#endif // DAA_RADIX_SORT_HPP
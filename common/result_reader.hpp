@@ -0,0 +1,237 @@
+/**
+ * @file result_reader.hpp
+ * @brief Reads the JSON Lines files written by results::Sink back into memory
+ * @details Each line is one flat object. The identifying fields (algorithm,
+ *          key, shape, n, dataset) go into a Cell; every other number becomes
+ *          a named value and every array of numbers (e.g. "samples_ns") a
+ *          named list. Nested arrays such as "payload" are skipped. A line that
+ *          is not a complete object, e.g. the last line of an interrupted run,
+ *          is counted and skipped.
+ */
+
+#ifndef DAA_RESULT_READER_HPP
+#define DAA_RESULT_READER_HPP
+
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "result_sink.hpp"
+
+namespace results {
+
+/**
+ * @struct Row
+ * @brief One cell of a results file.
+ */
+struct Row {
+    Cell cell;
+    std::vector<std::pair<std::string, double>> values;              ///< Other numeric fields.
+    std::vector<std::pair<std::string, std::vector<double>>> lists; ///< Arrays of numbers.
+
+    /// @brief The numeric field `name`, or nullptr.
+    const double* value(std::string_view name) const {
+        for (const auto& v : values)
+            if (v.first == name) return &v.second;
+        return nullptr;
+    }
+
+    /// @brief The array of numbers `name`, or nullptr.
+    const std::vector<double>* list(std::string_view name) const {
+        for (const auto& l : lists)
+            if (l.first == name) return &l.second;
+        return nullptr;
+    }
+};
+
+namespace detail {
+
+/**
+ * @class LineParser
+ * @brief Recursive-descent parser for the subset of JSON that Sink writes.
+ */
+class LineParser {
+public:
+    explicit LineParser(std::string_view text) : s(text) {}
+
+    bool parse(Row& row) {
+        if (!consume('{')) return false;
+        if (consume('}')) return end();
+        do {
+            std::string name;
+            if (!string(name) || !consume(':')) return false;
+            if (!member(name, row)) return false;
+        } while (consume(','));
+        return consume('}') && end();
+    }
+
+private:
+    std::string_view s;
+    std::size_t at = 0;
+
+    void space() {
+        while (at < s.size() && (s[at] == ' ' || s[at] == '\t' || s[at] == '\r')) at++;
+    }
+
+    bool consume(char c) {
+        space();
+        if (at < s.size() && s[at] == c) {
+            at++;
+            return true;
+        }
+        return false;
+    }
+
+    bool peek(char c) {
+        space();
+        return at < s.size() && s[at] == c;
+    }
+
+    bool end() {
+        space();
+        return at == s.size();
+    }
+
+    bool member(const std::string& name, Row& row) {
+        if (peek('"')) {
+            std::string v;
+            if (!string(v)) return false;
+            if (name == "algorithm") row.cell.algorithm = v;
+            else if (name == "key") row.cell.key = v;
+            else if (name == "shape") row.cell.shape = v;
+            return true;
+        }
+        if (peek('[')) {
+            std::vector<double> list;
+            std::size_t start = at;
+            if (numbers(list)) {
+                row.lists.emplace_back(name, std::move(list));
+                return true;
+            }
+            at = start; // not a flat list of numbers (e.g. the payload): skip it
+            return skip();
+        }
+        double v;
+        if (!number(v)) return skip();
+        if (name == "n") row.cell.n = (long long)v;
+        else if (name == "dataset") row.cell.dataset = (int)v;
+        else row.values.emplace_back(name, v);
+        return true;
+    }
+
+    bool number(double& v) {
+        space();
+        if (at >= s.size()) return false;
+        std::string token;
+        while (at < s.size() && (std::isdigit((unsigned char)s[at]) || s[at] == '-' || s[at] == '+' ||
+                                 s[at] == '.' || s[at] == 'e' || s[at] == 'E'))
+            token += s[at++];
+        char* stop = nullptr;
+        v = std::strtod(token.c_str(), &stop);
+        return !token.empty() && *stop == '\0';
+    }
+
+    bool numbers(std::vector<double>& out) {
+        if (!consume('[')) return false;
+        if (consume(']')) return true;
+        do {
+            double v;
+            if (!number(v)) return false;
+            out.push_back(v);
+        } while (consume(','));
+        return consume(']');
+    }
+
+    bool string(std::string& out) {
+        if (!consume('"')) return false;
+        while (at < s.size() && s[at] != '"') {
+            char c = s[at++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (at >= s.size()) return false;
+            char e = s[at++];
+            switch (e) {
+                case 'n': out += '\n'; break;
+                case 't': out += '\t'; break;
+                case 'r': out += '\r'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'u': {
+                    if (at + 4 > s.size()) return false;
+                    unsigned code = (unsigned)std::strtoul(std::string(s.substr(at, 4)).c_str(), nullptr, 16);
+                    at += 4;
+                    if (code < 0x80) out += (char)code; // Sink only escapes control characters
+                    else out += '?';
+                    break;
+                }
+                default: out += e;
+            }
+        }
+        return consume('"');
+    }
+
+    /// @brief Skips any value: string, number, literal, array or object.
+    bool skip() {
+        space();
+        if (at >= s.size()) return false;
+        if (s[at] == '"') {
+            std::string ignored;
+            return string(ignored);
+        }
+        if (s[at] == '[' || s[at] == '{') {
+            const char close = s[at] == '[' ? ']' : '}';
+            at++;
+            if (consume(close)) return true;
+            do {
+                if (close == '}') {
+                    std::string ignored;
+                    if (!string(ignored) || !consume(':')) return false;
+                }
+                if (!skip()) return false;
+            } while (consume(','));
+            return consume(close);
+        }
+        std::size_t start = at;
+        while (at < s.size() && s[at] != ',' && s[at] != ']' && s[at] != '}' && s[at] != ' ') at++;
+        return at > start;
+    }
+};
+
+} // namespace detail
+
+/// @brief Parses one line of a results file; false if it is not a complete object.
+inline bool parseLine(std::string_view line, Row& row) {
+    row = Row();
+    return detail::LineParser(line).parse(row);
+}
+
+/**
+ * @brief Appends the cells of the results file at `path` to `rows`.
+ * @param skipped Receives the number of non-empty lines that did not parse.
+ * @return false if the file could not be opened.
+ */
+inline bool load(const std::string& path, std::vector<Row>& rows, std::size_t* skipped = nullptr) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::size_t bad = 0;
+    std::string line;
+    Row row;
+    while (std::getline(in, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+        if (parseLine(line, row)) rows.push_back(std::move(row));
+        else bad++;
+    }
+    if (skipped) *skipped = bad;
+    return true;
+}
+
+} // namespace results
+
+#endif // DAA_RESULT_READER_HPP
@@ -0,0 +1,213 @@
+/**
+ * @file result_sink.hpp
+ * @brief One JSON Lines results file per run instead of a CSV per dataset
+ * @details The benchmark sweeps used to write every generated and sorted
+ *          dataset to its own CSV, so a 10 x 10 sweep over four keys created
+ *          400 files and, at larger sweeps, spent most of its time creating
+ *          them. Sink appends one JSON object per benchmark cell to a single
+ *          file through csv::Writer:
+ *
+ *              {"algorithm":"merge_sort","key":"age","shape":"uniform","n":10,
+ *               "dataset":1,"comparisons":25,"assignments":68,"median_ns":310}
+ *
+ *          (on one line), plus the raw latency samples as "samples_ns":[...]
+ *          where the program records them. With payloads enabled a cell also
+ *          carries its sorted rows as `"payload":[["Amit",17.5],...]`, keyed by
+ *          the same (algorithm, key, n, dataset) fields. Rows are only ever
+ *          appended, so a partial file from an interrupted run is still valid
+ *          up to its last complete line. common/result_reader.hpp reads the
+ *          file back.
+ */
+
+#ifndef DAA_RESULT_SINK_HPP
+#define DAA_RESULT_SINK_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "csv_writer.hpp"
+
+namespace results {
+
+/**
+ * @struct Cell
+ * @brief Identifies one benchmark measurement.
+ */
+struct Cell {
+    std::string algorithm;
+    std::string key;
+    long long n = 0;
+    int dataset = 0;        ///< 1-based, as in the per-dataset file names.
+    std::string shape = {}; ///< Input distribution (a gen::SHAPES name); not written if empty.
+};
+
+/**
+ * @class Sink
+ * @brief Writes benchmark cells as JSON Lines.
+ * @details A row is begin(cell), any number of field() calls, an optional
+ *          payload() and end().
+ */
+class Sink {
+public:
+    /**
+     * @brief Values of one payload row, written as a JSON array.
+     */
+    class Tuple {
+    public:
+        Tuple& value(std::string_view s) {
+            separate();
+            sink.string(s);
+            return *this;
+        }
+
+        template <class Int, class = std::enable_if_t<std::is_integral<Int>::value>>
+        Tuple& value(Int v) {
+            separate();
+            sink.out.put(v);
+            return *this;
+        }
+
+        /// @brief Fixed notation with `decimals` digits (as the CSV dumps print it).
+        Tuple& value(double v, int decimals) {
+            separate();
+            sink.out.fixed(v, decimals);
+            return *this;
+        }
+
+    private:
+        friend class Sink;
+        explicit Tuple(Sink& sink) : sink(sink) {}
+
+        Sink& sink;
+        bool first = true;
+
+        void separate() {
+            if (!first) sink.out.put(',');
+            first = false;
+        }
+    };
+
+    /**
+     * @param path Results file; replaced if it exists.
+     * @param payloads Whether payload() writes the rows or does nothing.
+     */
+    explicit Sink(const std::string& path, bool payloads = false)
+        : out(path), withPayloads(payloads) {}
+
+    /// @brief False if the file could not be opened or written.
+    bool ok() const { return out.ok(); }
+
+    /// @brief Whether cells carry their sorted rows.
+    bool payloads() const { return withPayloads; }
+
+    /// @brief Cells written so far.
+    std::size_t cells() const { return rows; }
+
+    /// @brief Starts the row of `cell` with its identifying fields.
+    Sink& begin(const Cell& cell) {
+        out.put('{');
+        first = true;
+        field("algorithm", cell.algorithm);
+        field("key", cell.key);
+        if (!cell.shape.empty()) field("shape", cell.shape);
+        field("n", cell.n);
+        return field("dataset", cell.dataset);
+    }
+
+    Sink& field(const char* name, std::string_view v) {
+        this->name(name);
+        string(v);
+        return *this;
+    }
+
+    template <class Int, class = std::enable_if_t<std::is_integral<Int>::value>>
+    Sink& field(const char* name, Int v) {
+        this->name(name);
+        out.put(v);
+        return *this;
+    }
+
+    /// @brief Shortest representation that reads back to `v`.
+    Sink& field(const char* name, double v) {
+        this->name(name);
+        out.put(v);
+        return *this;
+    }
+
+    /// @brief `[v,...]`, each the shortest representation that reads back (e.g. raw latency samples).
+    Sink& field(const char* name, const std::vector<double>& values) {
+        this->name(name);
+        out.put('[');
+        for (std::size_t i = 0; i < values.size(); i++) {
+            if (i > 0) out.put(',');
+            out.put(values[i]);
+        }
+        out.put(']');
+        return *this;
+    }
+
+    /**
+     * @brief Adds `"payload":[...]` with one array per element of `rows`, if payloads are on.
+     * @param row Called as `row(Tuple&, const T&)` to write one element's values.
+     */
+    template <class T, class Row>
+    Sink& payload(const std::vector<T>& rows, Row row) {
+        if (!withPayloads) return *this;
+        name("payload");
+        out.put('[');
+        for (std::size_t i = 0; i < rows.size(); i++) {
+            if (i > 0) out.put(',');
+            out.put('[');
+            Tuple tuple(*this);
+            row(tuple, rows[i]);
+            out.put(']');
+        }
+        out.put(']');
+        return *this;
+    }
+
+    /// @brief Closes the row.
+    void end() {
+        out.put("}\n");
+        rows++;
+    }
+
+    /// @brief Writes what is buffered and closes the file; returns ok().
+    bool finish() { return out.finish(); }
+
+private:
+    csv::Writer out;
+    bool withPayloads;
+    bool first = true;
+    std::size_t rows = 0;
+
+    void name(const char* key) {
+        if (!first) out.put(',');
+        first = false;
+        string(key);
+        out.put(':');
+    }
+
+    /// @brief JSON string literal, escaping quotes, backslashes and control characters.
+    void string(std::string_view s) {
+        static const char HEX[] = "0123456789abcdef";
+        out.put('"');
+        for (char c : s) {
+            if (c == '"' || c == '\\') {
+                out.put('\\').put(c);
+            } else if ((unsigned char)c < 0x20) {
+                out.put("\\u00").put(HEX[(unsigned char)c >> 4]).put(HEX[c & 15]);
+            } else {
+                out.put(c);
+            }
+        }
+        out.put('"');
+    }
+};
+
+} // namespace results
+
+#endif // DAA_RESULT_SINK_HPP
@@ -0,0 +1,213 @@
+/**
+ * @file selection.hpp
+ * @brief Order statistics without a full sort: k-th element, quantiles, top-k
+ * @details Quickselect partitions like quick sort but only keeps the side that
+ *          holds rank k, so it does O(n) expected work instead of O(n log n).
+ *          It reuses QuickSortOptions: the pivot rule and partition scheme are
+ *          the same, and with `depthLimit` it becomes introselect. After
+ *          2 log2(n) levels the remaining range is heapsorted, which bounds the
+ *          worst case at O(n log n).
+ *
+ *          selectRanks finds several ranks in one pass. It selects the middle
+ *          requested rank, then recurses with the lower ranks on the left part
+ *          and the higher ones on the right, which costs O(n log q) for q
+ *          ranks. TopK keeps the k largest elements of a stream in a bounded
+ *          min-heap, so it needs only O(k) memory and about n + n log k
+ *          comparisons, and the input never has to be held in full.
+ *
+ *          Everything counts through the usual policy hooks.
+ */
+
+#ifndef DAA_SELECTION_HPP
+#define DAA_SELECTION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "sorting.hpp"
+
+namespace sorting {
+
+/**
+ * @brief Rearranges data[low..high] so that data[k] is the element a sort would put there.
+ * @details Everything before k compares <= data[k] and everything after >= data[k].
+ */
+template <class T, class K, class Policy>
+void selectKth(std::vector<T>& data, std::ptrdiff_t low, std::ptrdiff_t high, std::ptrdiff_t k,
+               const K& key, const QuickSortOptions& opt, int depthLeft, std::mt19937& rng,
+               const Policy& p) {
+    while (high - low + 1 > opt.cutoff) {
+        if (opt.depthLimit && depthLeft == 0) {
+            if (opt.stats) opt.stats->heapSorts++;
+            heapSort(data, low, high, key, p);
+            return;
+        }
+        depthLeft--;
+
+        std::ptrdiff_t pv = choosePivot(data, low, high, opt.pivot, rng, key, p);
+        if (pv != high) {
+            std::swap(data[pv], data[high]);
+            p.assign(3);
+        }
+        std::ptrdiff_t first, last;
+        if (opt.threeWay) {
+            std::tie(first, last) = partition3(data, low, high, key, p);
+        } else {
+            first = last = partition(data, low, high, key, p);
+        }
+
+        if (k < first) high = first - 1;
+        else if (k > last) low = last + 1;
+        else return; // k landed in the pivot's run
+    }
+    if (low < high) insertionSort(data, low, high, key, p);
+}
+
+/// @brief Depth limit of introselect on n elements (same as quickSortWith).
+inline int selectDepthLimit(std::size_t n) {
+    return n < 2 ? 0 : 2 * (int)std::log2((double)n);
+}
+
+/**
+ * @brief The k-th smallest element (0-based) of the whole vector; `data` is partially reordered.
+ * @param opt Pivot/partition rules; QuickSortOptions::introsort() gives introselect.
+ */
+template <class T, class K, class Policy = NoCount>
+const T& selectKth(std::vector<T>& data, std::ptrdiff_t k, const K& key,
+                   const QuickSortOptions& opt = QuickSortOptions::introsort(), const Policy& p = Policy()) {
+    std::mt19937 rng(opt.seed);
+    selectKth(data, 0, (std::ptrdiff_t)data.size() - 1, k, key, opt, selectDepthLimit(data.size()), rng, p);
+    return data[k];
+}
+
+/**
+ * @brief Places every rank of ranks[first..last) (strictly ascending, inside [low, high]) as a sort would.
+ */
+template <class T, class K, class Policy>
+void selectRanks(std::vector<T>& data, std::ptrdiff_t low, std::ptrdiff_t high,
+                 const std::vector<std::ptrdiff_t>& ranks, std::size_t first, std::size_t last,
+                 const K& key, const QuickSortOptions& opt, std::mt19937& rng, const Policy& p) {
+    if (first >= last || low > high) return;
+    std::size_t mid = first + (last - first) / 2;
+    std::ptrdiff_t k = ranks[mid];
+    selectKth(data, low, high, k, key, opt, selectDepthLimit(high - low + 1), rng, p);
+    selectRanks(data, low, k - 1, ranks, first, mid, key, opt, rng, p);
+    selectRanks(data, k + 1, high, ranks, mid + 1, last, key, opt, rng, p);
+}
+
+/**
+ * @brief Places every rank in `ranks` (0-based, any order, repeats allowed) as a full sort would.
+ * @details Afterwards data[r] is the r-th smallest element for every r in `ranks`.
+ */
+template <class T, class K, class Policy = NoCount>
+void selectRanks(std::vector<T>& data, const std::vector<std::ptrdiff_t>& ranks, const K& key,
+                 const QuickSortOptions& opt = QuickSortOptions::introsort(), const Policy& p = Policy()) {
+    if (data.empty()) return;
+    std::vector<std::ptrdiff_t> distinct = ranks;
+    std::sort(distinct.begin(), distinct.end());
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    std::mt19937 rng(opt.seed);
+    selectRanks(data, 0, (std::ptrdiff_t)data.size() - 1, distinct, 0, distinct.size(), key, opt, rng, p);
+}
+
+/**
+ * @brief Nearest-rank index of quantile q among n elements (as timing::percentile).
+ * @details q is clamped to [0, 1] (NaN counts as 0). There is no rank among no
+ * elements: for n == 0 the result is -1 and must not be used as an index.
+ */
+inline std::ptrdiff_t quantileRank(std::size_t n, double q) {
+    if (n == 0) return -1;
+    q = q > 0 ? std::min(q, 1.0) : 0.0;
+    std::size_t rank = (std::size_t)std::ceil(q * n);
+    if (rank == 0) rank = 1;
+    return (std::ptrdiff_t)(rank > n ? n : rank) - 1;
+}
+
+/**
+ * @brief Values at the quantiles `qs`, found with one multi-rank selection.
+ * @return One value per quantile (each clamped to [0, 1]); empty if `data` is.
+ */
+template <class T, class K, class Policy = NoCount>
+std::vector<T> selectQuantiles(std::vector<T>& data, const std::vector<double>& qs, const K& key,
+                               const QuickSortOptions& opt = QuickSortOptions::introsort(),
+                               const Policy& p = Policy()) {
+    if (data.empty()) return {};
+    std::vector<std::ptrdiff_t> ranks;
+    for (double q : qs) ranks.push_back(quantileRank(data.size(), q));
+    selectRanks(data, ranks, key, opt, p);
+    std::vector<T> values;
+    for (std::ptrdiff_t r : ranks) values.push_back(data[r]);
+    return values;
+}
+
+/// @brief Key with the order reversed (used to turn siftDown's max-heap into a min-heap).
+template <class K>
+struct Reverse {
+    K key;
+
+    template <class T, class Policy>
+    int compare(const T& a, const T& b, const Policy& p) const {
+        return key.compare(b, a, p);
+    }
+};
+
+/**
+ * @class TopK
+ * @brief The k largest elements of a stream, kept in a bounded min-heap.
+ * @details The first k elements are collected unordered and heapified once;
+ *          after that each element costs one comparison against the heap root
+ *          and, if it is larger, one sift-down of log2(k) levels. Among equal
+ *          keys at the boundary, which ones are kept is unspecified.
+ */
+template <class T, class K, class Policy = NoCount>
+class TopK {
+public:
+    TopK(std::size_t k, const K& key = K(), const Policy& p = Policy()) : k(k), order{key}, p(p) {
+        heap.reserve(k);
+    }
+
+    void push(const T& item) {
+        if (k == 0) return;
+        if (heap.size() < k) {
+            heap.push_back(item);
+            p.assign();
+            if (heap.size() == k) heapify();
+            return;
+        }
+        // Root is the smallest of the current top k
+        if (order.key.compare(item, heap[0], p) <= 0) return;
+        heap[0] = item;
+        p.assign();
+        siftDown(heap.data(), 0, (std::ptrdiff_t)heap.size(), order, p);
+    }
+
+    /// @brief Elements seen so far that made the top k.
+    std::size_t size() const { return heap.size(); }
+
+    /// @brief The top k, largest first; the heap is consumed.
+    std::vector<T> take() {
+        heapSort(heap, order, p); // ascending in the reversed order
+        return std::move(heap);
+    }
+
+private:
+    std::size_t k;
+    Reverse<K> order;
+    Policy p;
+    std::vector<T> heap;
+
+    void heapify() {
+        const std::ptrdiff_t n = (std::ptrdiff_t)heap.size();
+        for (std::ptrdiff_t root = n / 2 - 1; root >= 0; root--)
+            siftDown(heap.data(), root, n, order, p);
+    }
+};
+
+} // namespace sorting
+
+#endif // DAA_SELECTION_HPP
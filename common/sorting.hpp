@@ -0,0 +1,629 @@
+/**
+ * @file sorting.hpp
+ * @brief Header-only insertion, merge and quick sort shared by all questions
+ * @details Every algorithm is a template over two things:
+ *          - a Key, which says how two elements are ordered (built from
+ *            compile-time field projections, see Field / Key / ThenBy);
+ *          - an instrumentation Policy, which decides what gets counted.
+ *
+ *          CountOps bumps the caller's comparison/assignment counters exactly
+ *          where the original hand-written kernels did, so summary.csv keeps
+ *          the same meaning. NoCount has empty inline hooks, so with it the
+ *          counting side effects compile away and the sort runs at full speed.
+ *
+ *          Merge sort comes in three flavours: the original recursive one that
+ *          allocates a temporary per merge, mergeSortBuffered (recursive, one
+ *          auxiliary buffer that the levels ping-pong through) and
+ *          mergeSortBottomUp (iterative, same single buffer). The last two can
+ *          reuse a caller-owned buffer across sorts.
+ *
+ *          quickSort is the original last-element Lomuto scheme. quickSortWith
+ *          adds selectable pivots (median-of-3, Tukey's ninther, random), a
+ *          three-way Dutch-flag partition for duplicate-heavy keys and an
+ *          introsort depth limit that hands hopeless ranges to heapSort.
+ */
+
+#ifndef DAA_SORTING_HPP
+#define DAA_SORTING_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sorting {
+
+// ============================================================================
+// Instrumentation policies
+// ============================================================================
+
+/**
+ * @struct NoCount
+ * @brief Policy that counts nothing; every hook is an empty inline function.
+ */
+struct NoCount {
+    void compare() const {}
+    void assign(long long = 1) const {}
+    void allocate() const {}
+    void inspect(long long = 1) const {}
+};
+
+/**
+ * @struct CountOps
+ * @brief Policy that adds to external comparison and assignment counters.
+ */
+struct CountOps {
+    long long* comparisons; ///< Incremented once per key comparison.
+    long long* assignments; ///< Incremented once per element write.
+    long long* allocations = nullptr; ///< Optional: incremented per buffer allocation.
+    long long* characters = nullptr;  ///< Optional: characters read by string key comparisons.
+
+    void compare() const { ++*comparisons; }
+    void assign(long long k = 1) const { *assignments += k; }
+    void allocate() const {
+        if (allocations) ++*allocations;
+    }
+    void inspect(long long k = 1) const {
+        if (characters) *characters += k;
+    }
+};
+
+// ============================================================================
+// Key projections
+// ============================================================================
+
+/// @brief Three-way comparison of two key values (-1, 0 or 1).
+template <class V>
+int threeWay(const V& x, const V& y) {
+    return x < y ? -1 : (y < x ? 1 : 0);
+}
+
+/// @brief Strings are compared in a single pass instead of two operator< calls.
+inline int threeWay(std::string_view x, std::string_view y) {
+    int c = x.compare(y);
+    return (c > 0) - (c < 0);
+}
+
+inline int threeWay(const std::string& x, const std::string& y) {
+    return threeWay(std::string_view(x), std::string_view(y));
+}
+
+/// @brief Policy-aware comparison; only counted string comparisons differ.
+template <class V, class Policy>
+int threeWay(const V& x, const V& y, const Policy&) {
+    return threeWay(x, y);
+}
+
+/**
+ * @brief Counted string comparison: also reports the characters read.
+ * @details Both strings are read up to the first mismatch (or the end of the
+ *          shorter one), i.e. two characters per position examined.
+ */
+inline int threeWay(std::string_view x, std::string_view y, const CountOps& p) {
+    const std::size_t shorter = x.size() < y.size() ? x.size() : y.size();
+    std::size_t i = 0;
+    while (i < shorter && x[i] == y[i]) i++;
+    p.inspect(2 * (long long)(i < shorter ? i + 1 : shorter));
+    if (i < shorter) return (unsigned char)x[i] < (unsigned char)y[i] ? -1 : 1;
+    return x.size() < y.size() ? -1 : (y.size() < x.size() ? 1 : 0);
+}
+
+inline int threeWay(const std::string& x, const std::string& y, const CountOps& p) {
+    return threeWay(std::string_view(x), std::string_view(y), p);
+}
+
+/**
+ * @struct Field
+ * @brief Projection that reads a data member chosen at compile time.
+ * @tparam Member Pointer to member, e.g. Field<&Record::age>.
+ */
+template <auto Member>
+struct Field {
+    template <class T>
+    const auto& operator()(const T& item) const { return item.*Member; }
+};
+
+/**
+ * @struct Key
+ * @brief Orders elements by a single projected value; one comparison per call.
+ */
+template <class Proj>
+struct Key {
+    Proj proj;
+
+    template <class T, class Policy>
+    int compare(const T& a, const T& b, const Policy& p) const {
+        p.compare();
+        return threeWay(proj(a), proj(b), p);
+    }
+};
+
+/**
+ * @struct ThenBy
+ * @brief Lexicographic key: Second is only consulted (and counted) on a tie.
+ */
+template <class First, class Second>
+struct ThenBy {
+    First first;
+    Second second;
+
+    template <class T, class Policy>
+    int compare(const T& a, const T& b, const Policy& p) const {
+        int c = first.compare(a, b, p);
+        return c != 0 ? c : second.compare(a, b, p);
+    }
+};
+
+// ============================================================================
+// Insertion sort
+// ============================================================================
+
+/**
+ * @brief Stable insertion sort of data[low..high] (inclusive).
+ * @details Counts one assignment for the key extraction, one per shift and one
+ *          for placing the key, plus one comparison per `data[j] > key` test.
+ */
+template <class T, class K, class Policy = NoCount>
+void insertionSort(std::vector<T>& data, std::ptrdiff_t low, std::ptrdiff_t high,
+                   const K& key, const Policy& p = Policy()) {
+    for (std::ptrdiff_t i = low + 1; i <= high; i++) {
+        T item = std::move(data[i]);
+        p.assign();
+        std::ptrdiff_t j = i - 1;
+        while (j >= low && key.compare(data[j], item, p) > 0) {
+            data[j + 1] = std::move(data[j]);
+            p.assign();
+            j--;
+        }
+        data[j + 1] = std::move(item);
+        p.assign();
+    }
+}
+
+/// @brief Insertion sort of the whole vector.
+template <class T, class K, class Policy = NoCount>
+void insertionSort(std::vector<T>& data, const K& key, const Policy& p = Policy()) {
+    insertionSort(data, 0, (std::ptrdiff_t)data.size() - 1, key, p);
+}
+
+// ============================================================================
+// Merge sort
+// ============================================================================
+
+/**
+ * @brief Merges the sorted runs [left, mid] and [mid + 1, right].
+ * @details Counts one assignment per element written to the temporary buffer
+ *          and one per element copied back, and one allocation for the buffer.
+ */
+template <class T, class K, class Policy>
+void merge(std::vector<T>& data, std::ptrdiff_t left, std::ptrdiff_t mid, std::ptrdiff_t right,
+           const K& key, const Policy& p) {
+    std::vector<T> temp;
+    temp.reserve(right - left + 1);
+    p.allocate();
+    std::ptrdiff_t i = left, j = mid + 1;
+
+    while (i <= mid && j <= right) {
+        if (key.compare(data[i], data[j], p) <= 0) {
+            temp.push_back(std::move(data[i++]));
+        } else {
+            temp.push_back(std::move(data[j++]));
+        }
+        p.assign();
+    }
+
+    while (i <= mid) {
+        temp.push_back(std::move(data[i++]));
+        p.assign();
+    }
+    while (j <= right) {
+        temp.push_back(std::move(data[j++]));
+        p.assign();
+    }
+
+    for (std::size_t l = 0; l < temp.size(); l++) {
+        data[left + l] = std::move(temp[l]);
+        p.assign();
+    }
+}
+
+/**
+ * @brief Stable top-down merge sort of data[left..right] (inclusive).
+ */
+template <class T, class K, class Policy = NoCount>
+void mergeSort(std::vector<T>& data, std::ptrdiff_t left, std::ptrdiff_t right,
+               const K& key, const Policy& p = Policy()) {
+    if (left < right) {
+        std::ptrdiff_t mid = left + (right - left) / 2;
+        mergeSort(data, left, mid, key, p);
+        mergeSort(data, mid + 1, right, key, p);
+        merge(data, left, mid, right, key, p);
+    }
+}
+
+/// @brief Merge sort of the whole vector.
+template <class T, class K, class Policy = NoCount>
+void mergeSort(std::vector<T>& data, const K& key, const Policy& p = Policy()) {
+    if (!data.empty())
+        mergeSort(data, 0, (std::ptrdiff_t)data.size() - 1, key, p);
+}
+
+/**
+ * @brief Merges src[left..mid] and src[mid+1..right] into dst[left..right].
+ * @details Counts one assignment per element written to `dst`.
+ */
+template <class T, class K, class Policy>
+void mergeInto(T* src, T* dst, std::ptrdiff_t left, std::ptrdiff_t mid, std::ptrdiff_t right,
+               const K& key, const Policy& p) {
+    std::ptrdiff_t i = left, j = mid + 1, out = left;
+    while (i <= mid && j <= right) {
+        dst[out++] = key.compare(src[i], src[j], p) <= 0 ? std::move(src[i++]) : std::move(src[j++]);
+        p.assign();
+    }
+    while (i <= mid) {
+        dst[out++] = std::move(src[i++]);
+        p.assign();
+    }
+    while (j <= right) {
+        dst[out++] = std::move(src[j++]);
+        p.assign();
+    }
+}
+
+/**
+ * @brief Sorts src[left..right]; the result lands in dst if `intoDst`, else in src.
+ * @details The halves are sorted into the other array, so every level merges
+ *          straight into its target and nothing is copied back. Ranges of at
+ *          most `cutoff` elements are insertion sorted in src (then moved).
+ */
+template <class T, class K, class Policy>
+void pingPongSort(T* src, T* dst, std::ptrdiff_t left, std::ptrdiff_t right, bool intoDst,
+                  std::ptrdiff_t cutoff, const K& key, const Policy& p) {
+    if (right - left + 1 <= cutoff) {
+        for (std::ptrdiff_t i = left + 1; i <= right; i++) {
+            T item = std::move(src[i]);
+            p.assign();
+            std::ptrdiff_t j = i - 1;
+            while (j >= left && key.compare(src[j], item, p) > 0) {
+                src[j + 1] = std::move(src[j]);
+                p.assign();
+                j--;
+            }
+            src[j + 1] = std::move(item);
+            p.assign();
+        }
+        if (intoDst) {
+            for (std::ptrdiff_t i = left; i <= right; i++) dst[i] = std::move(src[i]);
+            p.assign(right - left + 1);
+        }
+        return;
+    }
+    std::ptrdiff_t mid = left + (right - left) / 2;
+    pingPongSort(src, dst, left, mid, !intoDst, cutoff, key, p);
+    pingPongSort(src, dst, mid + 1, right, !intoDst, cutoff, key, p);
+    if (intoDst) mergeInto(src, dst, left, mid, right, key, p);
+    else mergeInto(dst, src, left, mid, right, key, p);
+}
+
+/// @brief Sizes the auxiliary buffer, counting an allocation only when it has to grow.
+template <class T, class Policy>
+void prepareBuffer(std::vector<T>& buffer, std::size_t n, const Policy& p) {
+    if (buffer.capacity() < n) p.allocate();
+    buffer.resize(n);
+}
+
+/**
+ * @brief Hybrid of mergeSortBuffered and insertion sort; stable.
+ * @param cutoff Ranges of at most this many elements are insertion sorted
+ *        (1 gives exactly mergeSortBuffered).
+ */
+template <class T, class K, class Policy = NoCount>
+void mergeSortHybrid(std::vector<T>& data, const K& key, std::ptrdiff_t cutoff,
+                     const Policy& p = Policy(), std::vector<T>* arena = nullptr) {
+    if (data.size() < 2) return;
+    std::vector<T> local;
+    std::vector<T>& buffer = arena ? *arena : local;
+    prepareBuffer(buffer, data.size(), p);
+    pingPongSort(data.data(), buffer.data(), 0, (std::ptrdiff_t)data.size() - 1, false,
+                 cutoff < 1 ? 1 : cutoff, key, p);
+}
+
+/**
+ * @brief Stable top-down merge sort with a single auxiliary buffer.
+ * @param arena Optional caller-owned buffer, reused across calls; without one a
+ *        buffer is allocated once for this sort.
+ */
+template <class T, class K, class Policy = NoCount>
+void mergeSortBuffered(std::vector<T>& data, const K& key, const Policy& p = Policy(),
+                       std::vector<T>* arena = nullptr) {
+    mergeSortHybrid(data, key, 1, p, arena);
+}
+
+/**
+ * @brief Stable bottom-up (iterative) merge sort with a single auxiliary buffer.
+ * @details Runs of width 1, 2, 4, ... are merged pairwise, alternating between
+ *          `data` and the buffer. If the last pass lands in the buffer the two
+ *          vectors are swapped (O(1)) rather than copied back.
+ * @param arena Optional caller-owned buffer, reused across calls.
+ */
+template <class T, class K, class Policy = NoCount>
+void mergeSortBottomUp(std::vector<T>& data, const K& key, const Policy& p = Policy(),
+                       std::vector<T>* arena = nullptr) {
+    const std::ptrdiff_t n = data.size();
+    if (n < 2) return;
+    std::vector<T> local;
+    std::vector<T>& buffer = arena ? *arena : local;
+    prepareBuffer(buffer, n, p);
+
+    T* src = data.data();
+    T* dst = buffer.data();
+    for (std::ptrdiff_t width = 1; width < n; width *= 2) {
+        for (std::ptrdiff_t left = 0; left < n; left += 2 * width) {
+            std::ptrdiff_t mid = std::min(left + width, n) - 1;
+            std::ptrdiff_t right = std::min(left + 2 * width, n) - 1;
+            mergeInto(src, dst, left, mid, right, key, p);
+        }
+        std::swap(src, dst);
+    }
+    if (src != data.data()) data.swap(buffer);
+}
+
+// ============================================================================
+// Quick sort
+// ============================================================================
+
+/**
+ * @brief Lomuto partition of data[low..high] around data[high].
+ * @details Counts one comparison per `data[j] <= pivot` test and three
+ *          assignments per swap.
+ * @return Final index of the pivot.
+ */
+template <class T, class K, class Policy>
+std::ptrdiff_t partition(std::vector<T>& data, std::ptrdiff_t low, std::ptrdiff_t high,
+                         const K& key, const Policy& p) {
+    const T& pivot = data[high]; // untouched until the final swap
+    std::ptrdiff_t i = low - 1;
+
+    for (std::ptrdiff_t j = low; j <= high - 1; j++) {
+        if (key.compare(data[j], pivot, p) <= 0) {
+            i++;
+            std::swap(data[i], data[j]);
+            p.assign(3);
+        }
+    }
+    std::swap(data[i + 1], data[high]);
+    p.assign(3);
+    return i + 1;
+}
+
+/**
+ * @brief Quick sort of data[low..high] (inclusive), last element as pivot.
+ */
+template <class T, class K, class Policy = NoCount>
+void quickSort(std::vector<T>& data, std::ptrdiff_t low, std::ptrdiff_t high,
+               const K& key, const Policy& p = Policy()) {
+    if (low < high) {
+        std::ptrdiff_t pi = partition(data, low, high, key, p);
+        quickSort(data, low, pi - 1, key, p);
+        quickSort(data, pi + 1, high, key, p);
+    }
+}
+
+/// @brief Quick sort of the whole vector.
+template <class T, class K, class Policy = NoCount>
+void quickSort(std::vector<T>& data, const K& key, const Policy& p = Policy()) {
+    if (!data.empty())
+        quickSort(data, 0, (std::ptrdiff_t)data.size() - 1, key, p);
+}
+
+// ============================================================================
+// Heap sort
+// ============================================================================
+
+/**
+ * @brief Restores the max-heap property below `root` in a[0..n).
+ * @details Counts the comparisons and one assignment per element moved.
+ */
+template <class T, class K, class Policy>
+void siftDown(T* a, std::ptrdiff_t root, std::ptrdiff_t n, const K& key, const Policy& p) {
+    T item = std::move(a[root]);
+    p.assign();
+    while (true) {
+        std::ptrdiff_t child = 2 * root + 1;
+        if (child >= n) break;
+        if (child + 1 < n && key.compare(a[child], a[child + 1], p) < 0) child++;
+        if (key.compare(item, a[child], p) >= 0) break;
+        a[root] = std::move(a[child]);
+        p.assign();
+        root = child;
+    }
+    a[root] = std::move(item);
+    p.assign();
+}
+
+/// @brief Heap sort of data[low..high] (inclusive); O(n log n) worst case, not stable.
+template <class T, class K, class Policy = NoCount>
+void heapSort(std::vector<T>& data, std::ptrdiff_t low, std::ptrdiff_t high,
+              const K& key, const Policy& p = Policy()) {
+    T* a = data.data() + low;
+    const std::ptrdiff_t n = high - low + 1;
+    for (std::ptrdiff_t root = n / 2 - 1; root >= 0; root--)
+        siftDown(a, root, n, key, p);
+    for (std::ptrdiff_t end = n - 1; end > 0; end--) {
+        std::swap(a[0], a[end]);
+        p.assign(3);
+        siftDown(a, 0, end, key, p);
+    }
+}
+
+/// @brief Heap sort of the whole vector.
+template <class T, class K, class Policy = NoCount>
+void heapSort(std::vector<T>& data, const K& key, const Policy& p = Policy()) {
+    if (!data.empty())
+        heapSort(data, 0, (std::ptrdiff_t)data.size() - 1, key, p);
+}
+
+// ============================================================================
+// Quick sort with pivot policies, three-way partition and introsort
+// ============================================================================
+
+/// @brief How quickSortWith picks the pivot of each range.
+enum class Pivot { Last, MedianOf3, Ninther, Random };
+
+/// @brief Filled in by quickSortWith when QuickSortOptions::stats is set.
+struct QuickSortStats {
+    std::size_t maxDepth = 0;  ///< Deepest partition level reached.
+    std::size_t heapSorts = 0; ///< Ranges handed to heapSort by the depth limit.
+};
+
+/**
+ * @struct QuickSortOptions
+ * @brief Pivot rule, partition scheme and depth limit for quickSortWith.
+ */
+struct QuickSortOptions {
+    Pivot pivot = Pivot::Last;
+    bool threeWay = false;            ///< Dutch-flag <, ==, > partition instead of Lomuto.
+    bool depthLimit = false;          ///< Introsort: heapsort below 2 log2(n) levels.
+    std::uint32_t seed = 1;           ///< Seed for Pivot::Random.
+    std::ptrdiff_t cutoff = 1;        ///< Ranges of at most this many elements are insertion sorted.
+    QuickSortStats* stats = nullptr;  ///< Optional depth/fallback report.
+
+    /// @brief Ninther pivot, three-way partition and depth limit.
+    static QuickSortOptions introsort() {
+        QuickSortOptions o;
+        o.pivot = Pivot::Ninther;
+        o.threeWay = true;
+        o.depthLimit = true;
+        return o;
+    }
+};
+
+/// @brief Index of the median of data[a], data[b], data[c] (counted comparisons).
+template <class T, class K, class Policy>
+std::ptrdiff_t medianOf3(const std::vector<T>& data, std::ptrdiff_t a, std::ptrdiff_t b, std::ptrdiff_t c,
+                         const K& key, const Policy& p) {
+    if (key.compare(data[a], data[b], p) < 0) {
+        if (key.compare(data[b], data[c], p) < 0) return b;
+        return key.compare(data[a], data[c], p) < 0 ? c : a;
+    }
+    if (key.compare(data[a], data[c], p) < 0) return a;
+    return key.compare(data[b], data[c], p) < 0 ? c : b;
+}
+
+/// @brief Pivot index for data[low..high] under `rule`.
+template <class T, class K, class Policy>
+std::ptrdiff_t choosePivot(const std::vector<T>& data, std::ptrdiff_t low, std::ptrdiff_t high, Pivot rule,
+                           std::mt19937& rng, const K& key, const Policy& p) {
+    const std::ptrdiff_t n = high - low + 1, mid = low + (high - low) / 2;
+    switch (rule) {
+        case Pivot::Last:
+            return high;
+        case Pivot::Random:
+            return std::uniform_int_distribution<std::ptrdiff_t>(low, high)(rng);
+        case Pivot::Ninther:
+            if (n >= 40) {
+                // Tukey: median of the medians of three evenly spaced triples
+                std::ptrdiff_t s = n / 8;
+                return medianOf3(data, medianOf3(data, low, low + s, low + 2 * s, key, p),
+                                 medianOf3(data, mid - s, mid, mid + s, key, p),
+                                 medianOf3(data, high - 2 * s, high - s, high, key, p), key, p);
+            }
+            return medianOf3(data, low, mid, high, key, p);
+        default:
+            return medianOf3(data, low, mid, high, key, p);
+    }
+}
+
+/**
+ * @brief Dutch national flag partition of data[low..high] around data[high].
+ * @details Counts one comparison per element classified, one assignment for
+ *          the pivot copy and three per swap.
+ * @return [first, last] of the run equal to the pivot.
+ */
+template <class T, class K, class Policy>
+std::pair<std::ptrdiff_t, std::ptrdiff_t> partition3(std::vector<T>& data, std::ptrdiff_t low,
+                                                     std::ptrdiff_t high, const K& key, const Policy& p) {
+    const T pivot = data[high];
+    p.assign();
+    std::ptrdiff_t lt = low, i = low, gt = high;
+    while (i <= gt) {
+        int c = key.compare(data[i], pivot, p);
+        if (c < 0) {
+            std::swap(data[lt++], data[i++]);
+            p.assign(3);
+        } else if (c > 0) {
+            std::swap(data[i], data[gt--]);
+            p.assign(3);
+        } else {
+            i++;
+        }
+    }
+    return {lt, gt};
+}
+
+/**
+ * @brief Quick sort of data[low..high] under `opt`.
+ * @details Recurses into the smaller side and loops on the larger one, so the
+ *          stack stays O(log n) even when the partitions are lopsided. Ranges
+ *          no longer than opt.cutoff finish with insertion sort.
+ */
+template <class T, class K, class Policy>
+void quickSortWith(std::vector<T>& data, std::ptrdiff_t low, std::ptrdiff_t high, const K& key,
+                   const QuickSortOptions& opt, int depthLeft, std::size_t depth, std::mt19937& rng,
+                   const Policy& p) {
+    while (high - low + 1 > opt.cutoff) {
+        if (opt.stats && depth > opt.stats->maxDepth) opt.stats->maxDepth = depth;
+        if (opt.depthLimit && depthLeft == 0) {
+            if (opt.stats) opt.stats->heapSorts++;
+            heapSort(data, low, high, key, p);
+            return;
+        }
+        depthLeft--;
+        depth++;
+
+        std::ptrdiff_t pv = choosePivot(data, low, high, opt.pivot, rng, key, p);
+        if (pv != high) {
+            std::swap(data[pv], data[high]);
+            p.assign(3);
+        }
+        std::ptrdiff_t leftEnd, rightBegin;
+        if (opt.threeWay) {
+            auto [lt, gt] = partition3(data, low, high, key, p);
+            leftEnd = lt - 1;
+            rightBegin = gt + 1;
+        } else {
+            std::ptrdiff_t pi = partition(data, low, high, key, p);
+            leftEnd = pi - 1;
+            rightBegin = pi + 1;
+        }
+
+        if (leftEnd - low < high - rightBegin) {
+            quickSortWith(data, low, leftEnd, key, opt, depthLeft, depth, rng, p);
+            low = rightBegin;
+        } else {
+            quickSortWith(data, rightBegin, high, key, opt, depthLeft, depth, rng, p);
+            high = leftEnd;
+        }
+    }
+    if (opt.stats && depth > opt.stats->maxDepth) opt.stats->maxDepth = depth;
+    if (low < high) insertionSort(data, low, high, key, p);
+}
+
+/// @brief Quick sort of the whole vector with the given pivot/partition/depth options.
+template <class T, class K, class Policy = NoCount>
+void quickSortWith(std::vector<T>& data, const K& key, const QuickSortOptions& opt,
+                   const Policy& p = Policy()) {
+    if (data.size() < 2) return;
+    std::mt19937 rng(opt.seed);
+    int limit = 2 * (int)std::log2((double)data.size());
+    quickSortWith(data, 0, (std::ptrdiff_t)data.size() - 1, key, opt, limit, 0, rng, p);
+}
+
+} // namespace sorting
+
+#endif // DAA_SORTING_HPP
@@ -0,0 +1,150 @@
+/**
+ * @file stats.hpp
+ * @brief Comparing two sets of benchmark samples, and growth-rate fits
+ * @details Latency samples are skewed and often bimodal (a slow first run, a
+ *          context switch), so two runs are compared by the ratio of their
+ *          medians rather than of their means:
+ *
+ *              bootstrapRatio  percentile bootstrap interval of
+ *                              median(candidate) / median(baseline), resampling
+ *                              both sides with replacement;
+ *              mannWhitney     one-sided rank-sum test that candidate samples
+ *                              tend to be larger (normal approximation with
+ *                              tie and continuity corrections).
+ *
+ *          fit() finds the constant c of y ~ c * f(n) for f = n log2 n or n^2
+ *          by least squares, as visualize.py does, so a change in the constant
+ *          shows up without plotting.
+ */
+
+#ifndef DAA_STATS_HPP
+#define DAA_STATS_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace stats {
+
+/// @brief Nearest-rank median (as timing::percentile(.., 0.5)); 0 for no samples.
+inline double median(std::vector<double> v) {
+    if (v.empty()) return 0;
+    std::size_t rank = (v.size() + 1) / 2 - 1;
+    std::nth_element(v.begin(), v.begin() + rank, v.end());
+    return v[rank];
+}
+
+/**
+ * @struct Interval
+ * @brief A point estimate with its confidence bounds.
+ */
+struct Interval {
+    double estimate = 0, low = 0, high = 0;
+};
+
+/**
+ * @brief Percentile bootstrap of median(candidate) / median(baseline).
+ * @param confidence Two-sided coverage, e.g. 0.95.
+ * @param resamples Bootstrap replicates.
+ * @details Both sides must be non-empty; a zero baseline median gives an infinite ratio.
+ */
+inline Interval bootstrapRatio(const std::vector<double>& baseline, const std::vector<double>& candidate,
+                               double confidence, int resamples, std::mt19937& rng) {
+    auto ratio = [](double c, double b) { return b > 0 ? c / b : (c > 0 ? INFINITY : 1.0); };
+    Interval out;
+    out.estimate = ratio(median(candidate), median(baseline));
+
+    std::vector<double> ratios, b(baseline.size()), c(candidate.size());
+    ratios.reserve(resamples);
+    std::uniform_int_distribution<std::size_t> pickB(0, baseline.size() - 1), pickC(0, candidate.size() - 1);
+    for (int r = 0; r < resamples; r++) {
+        for (double& x : b) x = baseline[pickB(rng)];
+        for (double& x : c) x = candidate[pickC(rng)];
+        ratios.push_back(ratio(median(c), median(b)));
+    }
+    std::sort(ratios.begin(), ratios.end());
+    const double tail = (1 - confidence) / 2;
+    out.low = ratios[(std::size_t)std::floor(tail * (resamples - 1))];
+    out.high = ratios[(std::size_t)std::ceil((1 - tail) * (resamples - 1))];
+    return out;
+}
+
+/**
+ * @brief One-sided Mann-Whitney U test: p-value that `candidate` is stochastically larger.
+ * @details Normal approximation with average ranks for ties, the tie-corrected
+ *          variance and a continuity correction; 1 when every sample is equal.
+ */
+inline double mannWhitney(const std::vector<double>& baseline, const std::vector<double>& candidate) {
+    const double m = (double)candidate.size(), k = (double)baseline.size(), total = m + k;
+    if (m == 0 || k == 0) return 1;
+
+    std::vector<std::pair<double, bool>> all; // (value, from candidate)
+    for (double x : baseline) all.emplace_back(x, false);
+    for (double x : candidate) all.emplace_back(x, true);
+    std::sort(all.begin(), all.end());
+
+    double rankSum = 0, ties = 0;
+    for (std::size_t i = 0; i < all.size();) {
+        std::size_t j = i;
+        while (j < all.size() && all[j].first == all[i].first) j++;
+        const double rank = (i + 1 + j) / 2.0, t = (double)(j - i); // average of ranks i+1 .. j
+        for (std::size_t q = i; q < j; q++)
+            if (all[q].second) rankSum += rank;
+        ties += t * t * t - t;
+        i = j;
+    }
+
+    const double u = rankSum - m * (m + 1) / 2;
+    const double variance = m * k / 12 * ((total + 1) - ties / (total * (total - 1)));
+    if (variance <= 0) return 1;
+    const double z = (u - m * k / 2 - 0.5) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/**
+ * @enum Growth
+ * @brief Model of a cost as a function of n.
+ */
+enum class Growth { NLogN, NSquared };
+
+/// @brief f(n) of `model`.
+inline double growth(Growth model, double n) {
+    return model == Growth::NLogN ? n * std::log2(std::max(n, 1.0)) : n * n;
+}
+
+/**
+ * @struct Fit
+ * @brief y ~ constant * f(n), and the relative RMS error of that fit.
+ */
+struct Fit {
+    double constant = 0;
+    double error = 0; ///< sqrt(sum (y - c f)^2 / sum y^2); 0 is a perfect fit.
+};
+
+/// @brief Least-squares constant of y ~ c * f(n) over the points (ns[i], ys[i]).
+inline Fit fit(Growth model, const std::vector<double>& ns, const std::vector<double>& ys) {
+    double ff = 0, fy = 0, yy = 0;
+    for (std::size_t i = 0; i < ns.size(); i++) {
+        const double f = growth(model, ns[i]);
+        ff += f * f;
+        fy += f * ys[i];
+        yy += ys[i] * ys[i];
+    }
+    Fit out;
+    if (ff == 0) return out;
+    out.constant = fy / ff;
+    double residual = 0;
+    for (std::size_t i = 0; i < ns.size(); i++) {
+        const double e = ys[i] - out.constant * growth(model, ns[i]);
+        residual += e * e;
+    }
+    out.error = yy > 0 ? std::sqrt(residual / yy) : 0;
+    return out;
+}
+
+} // namespace stats
+
+#endif // DAA_STATS_HPP
@@ -0,0 +1,114 @@
+/**
+ * @file string_sort.hpp
+ * @brief Bentley-Sedgewick multikey quicksort for string keys
+ * @details Comparison sorts compare whole strings, so rows sharing a long
+ *          prefix have that prefix re-read on every comparison. Multikey
+ *          quicksort instead partitions on one character position at a time
+ *          into <, == and > the pivot character, and only the == part moves
+ *          on to the next position. Every character is read a bounded number
+ *          of times, which the `inspect` hook counts as character reads (the
+ *          counted comparison sorts report the same metric, see threeWay).
+ *
+ *          Ranges of at most MKQS_CUTOFF rows finish with an insertion sort
+ *          that compares the remaining suffixes. The sort is not stable.
+ */
+
+#ifndef DAA_STRING_SORT_HPP
+#define DAA_STRING_SORT_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sorting.hpp"
+
+namespace sorting {
+
+/// Ranges of at most this many rows are insertion sorted.
+inline constexpr std::ptrdiff_t MKQS_CUTOFF = 16;
+
+/// @brief Character `d` of `s` shifted by one, or 0 past the end (counted as one read).
+template <class Policy>
+int charAt(std::string_view s, std::size_t d, const Policy& p) {
+    p.inspect();
+    return d < s.size() ? (unsigned char)s[d] + 1 : 0;
+}
+
+/**
+ * @brief Multikey quicksort of a[0..n), whose keys already agree on their first `d` characters.
+ * @details Counts one comparison per row classified against the pivot
+ *          character, three assignments per swap, and the insertion cutoff
+ *          like insertionSort (comparisons there are suffix comparisons).
+ */
+template <class T, class Proj, class Policy>
+void multikeyQuickSort(T* a, std::ptrdiff_t n, std::size_t d, const Key<Proj>& key, const Policy& p) {
+    auto text = [&](const T& item) { return std::string_view(key.proj(item)); };
+
+    if (n <= MKQS_CUTOFF) {
+        for (std::ptrdiff_t i = 1; i < n; i++) {
+            T item = std::move(a[i]);
+            p.assign();
+            std::ptrdiff_t j = i - 1;
+            while (j >= 0) {
+                p.compare();
+                std::string_view x = text(a[j]), y = text(item);
+                if (threeWay(x.substr(d < x.size() ? d : x.size()), y.substr(d < y.size() ? d : y.size()), p) <= 0)
+                    break;
+                a[j + 1] = std::move(a[j]);
+                p.assign();
+                j--;
+            }
+            a[j + 1] = std::move(item);
+            p.assign();
+        }
+        return;
+    }
+
+    // Median of three pivot characters
+    int x = charAt(text(a[0]), d, p);
+    int y = charAt(text(a[n / 2]), d, p);
+    int z = charAt(text(a[n - 1]), d, p);
+    if (y < x) std::swap(x, y);
+    if (z < y) std::swap(y, z);
+    if (y < x) std::swap(x, y);
+    const int pivot = y;
+
+    // [0, lt) < pivot, [lt, gt) == pivot, [gt, n) > pivot at position d
+    std::ptrdiff_t lt = 0, i = 0, gt = n;
+    while (i < gt) {
+        int c = charAt(text(a[i]), d, p);
+        p.compare();
+        if (c < pivot) {
+            std::swap(a[lt++], a[i++]);
+            p.assign(3);
+        } else if (c > pivot) {
+            std::swap(a[i], a[--gt]);
+            p.assign(3);
+        } else {
+            i++;
+        }
+    }
+
+    multikeyQuickSort(a, lt, d, key, p);
+    if (pivot != 0) multikeyQuickSort(a + lt, gt - lt, d + 1, key, p); // 0: those strings have ended
+    multikeyQuickSort(a + gt, n - gt, d, key, p);
+}
+
+/**
+ * @brief Multikey quicksort of the whole vector by a string field.
+ * @param key A single-field string key, e.g. Key<Field<&Record::name>>.
+ */
+template <class T, class Proj, class Policy = NoCount>
+void multikeyQuickSort(std::vector<T>& data, const Key<Proj>& key, const Policy& p = Policy()) {
+    using V = std::decay_t<decltype(key.proj(std::declval<const T&>()))>;
+    static_assert(std::is_convertible<const V&, std::string_view>::value,
+                  "multikeyQuickSort needs a string key");
+    multikeyQuickSort(data.data(), (std::ptrdiff_t)data.size(), 0, key, p);
+}
+
+} // namespace sorting
+
+#endif // DAA_STRING_SORT_HPP
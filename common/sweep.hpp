@@ -0,0 +1,266 @@
+/**
+ * @file sweep.hpp
+ * @brief Size ranges and command-line settings of a benchmark sweep
+ * @details The Name-Age benchmarks used to run n = 10, 20, ..., 100 with 10
+ *          datasets each and a time-based seed. Config holds the same settings
+ *          so they can come from the command line instead:
+ *
+ *              --n 10:100:10       linear: 10, 20, ..., 100
+ *              --n 10:1e8:x10      geometric: 10, 100, ..., 10^8
+ *              --n 1000:1e6:x2     geometric, factor 2 (rounded, distinct sizes)
+ *              --datasets D        datasets per size
+ *              --seed S            base seed (the default is the clock)
+ *              --key age,name      subset of keys, comma-separated
+ *              --algorithm NAME    program-specific sort variant
+ *              --shape NAME        input distribution (gen::SHAPES, default uniform)
+ *              --out DIR           directory for the result files (--dumps
+ *                                  datasets go to DIR/data)
+ *              --threads N         cells run concurrently
+ *
+ *          Numbers may use exponent notation (1e8).
+ *
+ *          Every (n, dataset) cell draws its input from its own generator,
+ *          seeded from (base seed, n, dataset) by cellSeed, so a cell's data do
+ *          not depend on which cells ran before it. runOrdered runs the cells on
+ *          a thread pool and hands the results back in cell order, so result
+ *          files come out the same for any thread count.
+ */
+
+#ifndef DAA_SWEEP_HPP
+#define DAA_SWEEP_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cli.hpp"
+#include "generators.hpp"
+#include "thread_pool.hpp"
+
+namespace sweep {
+
+/**
+ * @struct Sizes
+ * @brief Values of n: linear from `from` by `step`, or geometric by `factor`.
+ */
+struct Sizes {
+    long long from = 10;
+    long long to = 100;
+    long long step = 10;
+    double factor = 0; ///< Above 1 for a geometric range; `step` is then unused.
+
+    /// @brief The sizes in increasing order (each at most `to`).
+    std::vector<long long> values() const {
+        std::vector<long long> out;
+        if (factor > 1) {
+            for (double x = (double)from; std::llround(x) <= to; x *= factor) {
+                long long n = std::llround(x);
+                if (out.empty() || n > out.back()) out.push_back(n);
+            }
+        } else {
+            for (long long n = from; n <= to; n += step) out.push_back(n);
+        }
+        return out;
+    }
+};
+
+/// @brief Parses a count like "100000" or "1e8"; false unless it is a whole number >= 1.
+inline bool parseCount(const std::string& text, long long& out) {
+    char* end = nullptr;
+    double v = std::strtod(text.c_str(), &end);
+    if (text.empty() || *end != '\0' || v < 1 || v > 9e18 || v != std::floor(v)) return false;
+    out = (long long)v;
+    return true;
+}
+
+/**
+ * @brief Parses "FROM:TO:STEP" or "FROM:TO:xFACTOR" (a single "N" means just N).
+ * @return false (leaving `out` unchanged) if the text is malformed or the range is empty.
+ */
+inline bool parseSizes(const std::string& text, Sizes& out) {
+    std::vector<std::string> parts;
+    std::size_t start = 0;
+    while (true) {
+        std::size_t colon = text.find(':', start);
+        parts.push_back(text.substr(start, colon - start));
+        if (colon == std::string::npos) break;
+        start = colon + 1;
+    }
+
+    Sizes s;
+    if (parts.size() == 1) {
+        if (!parseCount(parts[0], s.from)) return false;
+        s.to = s.from;
+        s.step = 1;
+    } else if (parts.size() == 3) {
+        if (!parseCount(parts[0], s.from) || !parseCount(parts[1], s.to) || s.to < s.from) return false;
+        const std::string& step = parts[2];
+        if (!step.empty() && (step[0] == 'x' || step[0] == '*')) {
+            char* end = nullptr;
+            s.factor = std::strtod(step.c_str() + 1, &end);
+            if (*end != '\0' || !(s.factor > 1)) return false;
+        } else if (!parseCount(step, s.step)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+    out = s;
+    return true;
+}
+
+/// @brief Splits "a,b,c" into its non-empty items.
+inline std::vector<std::string> splitList(const std::string& text) {
+    std::vector<std::string> items;
+    std::size_t start = 0;
+    while (start <= text.size()) {
+        std::size_t comma = text.find(',', start);
+        if (comma == std::string::npos) comma = text.size();
+        if (comma > start) items.push_back(text.substr(start, comma - start));
+        start = comma + 1;
+    }
+    return items;
+}
+
+/**
+ * @struct Config
+ * @brief One benchmark sweep: sizes, datasets, seed, keys, algorithm, input shape and output directory.
+ */
+struct Config {
+    Sizes sizes;
+    int datasets = 10;
+    std::uint64_t seed = 0;
+    std::vector<std::string> keys;
+    std::string algorithm;
+    gen::Shape shape = gen::Shape::Uniform;
+    std::string outDir = "../results";
+    unsigned threads = 1;
+
+    /// @brief Directory of the --dumps input datasets: ../data next to the default
+    /// ../results, otherwise a `data` directory inside outDir.
+    std::string dataDir() const { return outDir == "../results" ? "../data" : outDir + "/data"; }
+};
+
+/// @brief The flags parse() reads; each takes a value (for cli::checkFlags).
+inline const std::vector<std::string> OPTIONS = {"--n", "--datasets", "--seed", "--key", "--algorithm",
+                                                 "--shape", "--out", "--threads"};
+
+/**
+ * @brief Overrides the fields of `cfg` given on the command line (see the file comment).
+ * @details `cfg` holds the program's defaults; the seed defaults to the current time.
+ * @param error Receives a message for the first malformed flag.
+ * @return false if a flag was malformed.
+ */
+inline bool parse(int argc, char* argv[], Config& cfg, std::string& error) {
+    cfg.seed = (std::uint64_t)std::time(nullptr);
+    if (const char* n = cli::value(argc, argv, "--n")) {
+        if (!parseSizes(n, cfg.sizes)) {
+            error = std::string("bad --n ") + n + " (want FROM:TO:STEP or FROM:TO:xFACTOR)";
+            return false;
+        }
+    }
+    if (const char* d = cli::value(argc, argv, "--datasets")) {
+        long long count;
+        if (!parseCount(d, count) || count > 1000000) {
+            error = std::string("bad --datasets ") + d;
+            return false;
+        }
+        cfg.datasets = (int)count;
+    }
+    if (const char* s = cli::value(argc, argv, "--seed")) {
+        char* end = nullptr;
+        cfg.seed = std::strtoull(s, &end, 10);
+        if (*s == '\0' || *end != '\0') {
+            error = std::string("bad --seed ") + s;
+            return false;
+        }
+    }
+    if (const char* k = cli::value(argc, argv, "--key")) {
+        cfg.keys = splitList(k);
+        if (cfg.keys.empty()) {
+            error = "empty --key";
+            return false;
+        }
+    }
+    if (const char* a = cli::value(argc, argv, "--algorithm")) cfg.algorithm = a;
+    if (const char* sh = cli::value(argc, argv, "--shape")) {
+        const gen::ShapeInfo* info = gen::findShape(sh);
+        if (!info) {
+            error = std::string("unknown --shape ") + sh + " (" + gen::shapeNames() + ")";
+            return false;
+        }
+        cfg.shape = info->shape;
+    }
+    if (const char* o = cli::value(argc, argv, "--out")) cfg.outDir = o;
+    return cli::intValue(argc, argv, "--threads", cfg.threads, 1, 1024, error);
+}
+
+/// @brief SplitMix64 finaliser: spreads nearby inputs over the whole 64-bit range.
+inline std::uint64_t mix(std::uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+/// @brief Seed of the (n, dataset) cell of a sweep with base seed `base`.
+inline std::uint64_t cellSeed(std::uint64_t base, long long n, int dataset) {
+    return mix(mix(mix(base) ^ (std::uint64_t)n) ^ (std::uint64_t)dataset);
+}
+
+/// @brief Generator of the (n, dataset) cell (all 64 seed bits go into the state).
+inline std::mt19937 cellRng(std::uint64_t base, long long n, int dataset) {
+    std::uint64_t s = cellSeed(base, n, dataset);
+    std::seed_seq seq{(std::uint32_t)s, (std::uint32_t)(s >> 32)};
+    return std::mt19937(seq);
+}
+
+/**
+ * @brief Runs `cell(i)` for i in [0, count) on `threads` threads; emit(i, result) sees them in order.
+ * @details Each result is emitted as soon as it and every earlier one are done.
+ *          At most 2 * threads cells are started ahead of the next one to emit,
+ *          which bounds how many results are held. `cell` runs concurrently
+ *          with itself and must not touch shared state; `emit` runs on the
+ *          calling thread only. With one thread this is a plain loop.
+ */
+template <class Cell, class Emit>
+void runOrdered(unsigned threads, std::size_t count, Cell cell, Emit emit) {
+    if (threads <= 1) {
+        for (std::size_t i = 0; i < count; i++) emit(i, cell(i));
+        return;
+    }
+
+    using Result = decltype(cell(std::size_t()));
+    std::vector<std::optional<Result>> results(count);
+    std::unique_ptr<std::atomic<bool>[]> done(new std::atomic<bool>[count]());
+    parallel::ThreadPool pool(threads);
+    parallel::TaskGroup group(pool);
+    const std::size_t window = 2 * (std::size_t)threads;
+    std::size_t started = 0;
+
+    for (std::size_t next = 0; next < count; next++) {
+        for (; started < count && started < next + window; started++) {
+            group.run([&results, &done, &cell, i = started] {
+                results[i].emplace(cell(i));
+                done[i].store(true, std::memory_order_release);
+            });
+        }
+        while (!done[next].load(std::memory_order_acquire))
+            if (!pool.runOne()) std::this_thread::yield();
+        emit(next, std::move(*results[next]));
+        results[next].reset();
+    }
+}
+
+} // namespace sweep
+
+#endif // DAA_SWEEP_HPP
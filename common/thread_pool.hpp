@@ -0,0 +1,170 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Small work-stealing thread pool with fork/join task groups
+ * @details Every worker owns a deque: it pushes and pops its own tasks at the
+ *          back (LIFO, cache friendly for divide and conquer) and steals from
+ *          the front of other deques when it runs dry. Threads outside the pool
+ *          share slot 0. A thread waiting on a TaskGroup keeps executing tasks
+ *          instead of blocking, so nested fork/join cannot deadlock.
+ */
+
+#ifndef DAA_THREAD_POOL_HPP
+#define DAA_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel {
+
+/**
+ * @class ThreadPool
+ * @brief `threads - 1` workers; the submitting thread is the remaining one.
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(unsigned threads) : queues(threads < 1 ? 1 : threads) {
+        for (auto& q : queues) q.reset(new Queue());
+        for (unsigned slot = 1; slot < queues.size(); slot++)
+            workers.emplace_back([this, slot] { workerLoop(slot); });
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& w : workers) w.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /// @brief Total threads that execute tasks (workers + caller).
+    unsigned size() const { return (unsigned)queues.size(); }
+
+    /// @brief Queues `task` on the calling thread's deque.
+    void submit(Task task) {
+        Queue& q = *queues[mySlot()];
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.push_back(std::move(task));
+        }
+        queued.fetch_add(1, std::memory_order_release);
+        { std::lock_guard<std::mutex> lock(sleepMutex); } // no lost wake-ups
+        wake.notify_one();
+    }
+
+    /// @brief Runs one task (own deque first, then stealing). False if none found.
+    bool runOne() {
+        Task task;
+        if (!take(task)) return false;
+        task();
+        return true;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<long> queued{0};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    /// Pool and slot of the current thread (slot 0 for outside threads).
+    static const ThreadPool*& currentPool() {
+        static thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+    static unsigned& currentSlot() {
+        static thread_local unsigned slot = 0;
+        return slot;
+    }
+    unsigned mySlot() const { return currentPool() == this ? currentSlot() : 0; }
+
+    bool take(Task& task) {
+        const unsigned self = mySlot();
+        {
+            Queue& q = *queues[self];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (!q.tasks.empty()) {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        for (unsigned k = 1; k < queues.size(); k++) {
+            Queue& victim = *queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(unsigned slot) {
+        currentPool() = this;
+        currentSlot() = slot;
+        while (true) {
+            if (runOne()) continue;
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            wake.wait(lock, [this] { return stopping || queued.load(std::memory_order_acquire) > 0; });
+            if (stopping) return;
+        }
+    }
+};
+
+/**
+ * @class TaskGroup
+ * @brief Fork/join scope: run() forks, wait() joins while helping with other tasks.
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool) : pool(pool) {}
+    ~TaskGroup() { wait(); }
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /// @brief Forks `fn` as a task; it may run on any pool thread.
+    template <class Fn>
+    void run(Fn fn) {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        pool.submit([this, fn]() mutable {
+            fn();
+            pending.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    /// @brief Returns once every forked task has finished.
+    void wait() {
+        while (pending.load(std::memory_order_acquire) > 0)
+            if (!pool.runOne()) std::this_thread::yield();
+    }
+
+private:
+    ThreadPool& pool;
+    std::atomic<long> pending{0};
+};
+
+} // namespace parallel
+
+#endif // DAA_THREAD_POOL_HPP
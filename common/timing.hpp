@@ -0,0 +1,105 @@
+/**
+ * @file timing.hpp
+ * @brief Wall-clock latency harness for the sort benchmarks
+ * @details Each sample copies the unsorted input (untimed), then times a single
+ *          sort with std::chrono::steady_clock. The first `warmup` runs are
+ *          discarded so caches and the allocator are warm. Samples for one
+ *          (algorithm, key, n) cell are pooled across datasets and reduced to
+ *          min / median / p95 / p99 in nanoseconds.
+ */
+
+#ifndef DAA_TIMING_HPP
+#define DAA_TIMING_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace timing {
+
+/**
+ * @struct Config
+ * @brief Number of discarded and recorded runs per dataset.
+ */
+struct Config {
+    int warmup = 2;      ///< Runs executed but not recorded.
+    int repetitions = 5; ///< Runs recorded per dataset.
+};
+
+/**
+ * @struct Stats
+ * @brief Latency summary of one benchmark cell, in nanoseconds.
+ */
+struct Stats {
+    double min = 0, median = 0, p95 = 0, p99 = 0;
+};
+
+/// @brief Keeps the compiler from discarding the sorted output.
+inline void clobber(const void* p) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(p) : "memory");
+#else
+    static const void* volatile sink;
+    sink = p;
+#endif
+}
+
+/// @brief Nearest-rank percentile of an ascending sample vector.
+inline double percentile(const std::vector<double>& sorted, double q) {
+    if (sorted.empty()) return 0.0;
+    std::size_t rank = (std::size_t)std::ceil(q * sorted.size());
+    if (rank == 0) rank = 1;
+    return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+/// @brief Reduces raw samples to min / median / p95 / p99.
+inline Stats summarize(std::vector<double> samples) {
+    Stats s;
+    if (samples.empty()) return s;
+    std::sort(samples.begin(), samples.end());
+    s.min = samples.front();
+    s.median = percentile(samples, 0.50);
+    s.p95 = percentile(samples, 0.95);
+    s.p99 = percentile(samples, 0.99);
+    return s;
+}
+
+/**
+ * @brief Times `sortFn` on fresh copies of `original` and appends the samples.
+ * @param original Unsorted input; never modified.
+ * @param sortFn Callable taking `std::vector<T>&`; should use an uncounted policy.
+ * @param cfg Warm-up and repetition counts.
+ * @param out Receives one sample (ns) per recorded repetition.
+ */
+template <class T, class SortFn>
+void sample(const std::vector<T>& original, SortFn sortFn, const Config& cfg,
+            std::vector<double>& out) {
+    using clock = std::chrono::steady_clock;
+    std::vector<T> work;
+    for (int r = 0; r < cfg.warmup + cfg.repetitions; r++) {
+        work = original;
+        auto start = clock::now();
+        sortFn(work);
+        auto stop = clock::now();
+        clobber(work.data());
+        if (r >= cfg.warmup)
+            out.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+}
+
+/// @brief CSV header fragment for one key, e.g. "age_min_ns,...,age_p99_ns".
+inline std::string header(const std::string& prefix) {
+    return prefix + "_min_ns," + prefix + "_median_ns," + prefix + "_p95_ns," + prefix + "_p99_ns";
+}
+
+/// @brief Writes ",min,median,p95,p99" using the stream's current formatting.
+inline void writeStats(std::ostream& out, const Stats& s) {
+    out << "," << s.min << "," << s.median << "," << s.p95 << "," << s.p99;
+}
+
+} // namespace timing
+
+#endif // DAA_TIMING_HPP
@@ -0,0 +1,437 @@
+/**
+ * @file timsort.hpp
+ * @brief Adaptive, run-detecting stable merge sort (TimSort)
+ * @details The input is scanned for natural runs: non-descending ones are
+ *          kept, strictly descending ones are reversed in place (strictness
+ *          keeps the sort stable). Runs shorter than minRunLength(n) are
+ *          extended with binary insertion sort. Runs go on a stack whose
+ *          lengths are kept roughly Fibonacci-like, so merges stay balanced,
+ *          and each merge first gallops to skip the prefix of the left run and
+ *          the suffix of the right run that are already in place. Only the
+ *          smaller remaining run is copied to the scratch buffer. When one side
+ *          keeps winning, the merge switches from pairwise comparisons to
+ *          exponential (galloping) search.
+ *
+ *          Already-sorted input is a single run: n - 1 comparisons and no
+ *          moves. A sorted extract with a few changed or appended rows costs
+ *          about O(n) plus the work to merge the few short runs.
+ */
+
+#ifndef DAA_TIMSORT_HPP
+#define DAA_TIMSORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "sorting.hpp"
+
+namespace sorting {
+
+/// Consecutive wins before a merge switches to galloping (adapted per merge).
+inline constexpr std::ptrdiff_t MIN_GALLOP = 7;
+
+/// @brief Filled in by timSort when a stats pointer is given.
+struct TimSortStats {
+    std::size_t runs = 0;    ///< Natural runs found (before extension to minrun).
+    std::size_t merges = 0;  ///< Run merges performed.
+    std::size_t gallops = 0; ///< Times a merge entered galloping mode.
+};
+
+/// @brief Minimum run length: n / 2^k in [32, 64], rounded up if any bit was shifted out.
+inline std::ptrdiff_t minRunLength(std::ptrdiff_t n) {
+    std::ptrdiff_t r = 0;
+    while (n >= 64) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+/**
+ * @class TimSorter
+ * @brief State of one timSort call: the data, the run stack and the scratch buffer.
+ * @details Counts every key comparison and one assignment per element written
+ *          (three per swap when reversing descending runs).
+ */
+template <class T, class K, class Policy>
+class TimSorter {
+public:
+    TimSorter(std::vector<T>& data, const K& key, const Policy& p, TimSortStats* stats)
+        : a(data.data()), key(key), p(p), stats(stats) {}
+
+    void sort(std::ptrdiff_t n) {
+        if (n < 2) return;
+        const std::ptrdiff_t minRun = minRunLength(n);
+        std::ptrdiff_t lo = 0, remaining = n;
+        while (remaining > 0) {
+            std::ptrdiff_t len = countRunAndMakeAscending(lo, lo + remaining);
+            if (stats) stats->runs++;
+            if (len < minRun) {
+                std::ptrdiff_t forced = std::min(minRun, remaining);
+                binaryInsertionSort(lo, lo + forced, lo + len);
+                len = forced;
+            }
+            runs.push_back({lo, len});
+            mergeCollapse();
+            lo += len;
+            remaining -= len;
+        }
+        while (runs.size() > 1) {
+            std::size_t i = runs.size() - 2;
+            if (i > 0 && runs[i - 1].len < runs[i + 1].len) i--;
+            mergeAt(i);
+        }
+    }
+
+private:
+    struct Run {
+        std::ptrdiff_t base, len;
+    };
+
+    T* a;
+    const K& key;
+    const Policy& p;
+    TimSortStats* stats;
+    std::vector<Run> runs;
+    std::vector<T> tmp;
+    std::ptrdiff_t minGallop = MIN_GALLOP;
+
+    bool less(const T& x, const T& y) const { return key.compare(x, y, p) < 0; }
+
+    /// Length of the run starting at lo; a strictly descending run is reversed.
+    std::ptrdiff_t countRunAndMakeAscending(std::ptrdiff_t lo, std::ptrdiff_t hi) {
+        std::ptrdiff_t r = lo + 1;
+        if (r == hi) return 1;
+        if (less(a[r], a[lo])) {
+            while (++r < hi && less(a[r], a[r - 1])) {}
+            for (std::ptrdiff_t i = lo, j = r - 1; i < j; i++, j--) {
+                std::swap(a[i], a[j]);
+                p.assign(3);
+            }
+        } else {
+            while (++r < hi && !less(a[r], a[r - 1])) {}
+        }
+        return r - lo;
+    }
+
+    /// Sorts a[lo..hi) given that a[lo..start) is sorted; binary search, then shift.
+    void binaryInsertionSort(std::ptrdiff_t lo, std::ptrdiff_t hi, std::ptrdiff_t start) {
+        for (; start < hi; start++) {
+            T pivot = std::move(a[start]);
+            p.assign();
+            std::ptrdiff_t left = lo, right = start;
+            while (left < right) {
+                std::ptrdiff_t mid = left + (right - left) / 2;
+                if (less(pivot, a[mid])) right = mid;
+                else left = mid + 1;
+            }
+            std::move_backward(a + left, a + start, a + start + 1);
+            p.assign(start - left);
+            a[left] = std::move(pivot);
+            p.assign();
+        }
+    }
+
+    /// Leftmost position for x in sorted b[0..n): b[k-1] < x <= b[k]; search starts at hint.
+    std::ptrdiff_t gallopLeft(const T& x, const T* b, std::ptrdiff_t n, std::ptrdiff_t hint) const {
+        std::ptrdiff_t lastOfs = 0, ofs = 1;
+        if (less(b[hint], x)) {
+            const std::ptrdiff_t maxOfs = n - hint;
+            while (ofs < maxOfs && less(b[hint + ofs], x)) {
+                lastOfs = ofs;
+                ofs = 2 * ofs + 1;
+            }
+            ofs = std::min(ofs, maxOfs);
+            lastOfs += hint;
+            ofs += hint;
+        } else {
+            const std::ptrdiff_t maxOfs = hint + 1;
+            while (ofs < maxOfs && !less(b[hint - ofs], x)) {
+                lastOfs = ofs;
+                ofs = 2 * ofs + 1;
+            }
+            ofs = std::min(ofs, maxOfs);
+            std::ptrdiff_t k = lastOfs;
+            lastOfs = hint - ofs;
+            ofs = hint - k;
+        }
+        // b[lastOfs] < x <= b[ofs]: binary search the gap
+        lastOfs++;
+        while (lastOfs < ofs) {
+            std::ptrdiff_t m = lastOfs + (ofs - lastOfs) / 2;
+            if (less(b[m], x)) lastOfs = m + 1;
+            else ofs = m;
+        }
+        return ofs;
+    }
+
+    /// Rightmost position for x in sorted b[0..n): b[k-1] <= x < b[k]; search starts at hint.
+    std::ptrdiff_t gallopRight(const T& x, const T* b, std::ptrdiff_t n, std::ptrdiff_t hint) const {
+        std::ptrdiff_t lastOfs = 0, ofs = 1;
+        if (less(x, b[hint])) {
+            const std::ptrdiff_t maxOfs = hint + 1;
+            while (ofs < maxOfs && less(x, b[hint - ofs])) {
+                lastOfs = ofs;
+                ofs = 2 * ofs + 1;
+            }
+            ofs = std::min(ofs, maxOfs);
+            std::ptrdiff_t k = lastOfs;
+            lastOfs = hint - ofs;
+            ofs = hint - k;
+        } else {
+            const std::ptrdiff_t maxOfs = n - hint;
+            while (ofs < maxOfs && !less(x, b[hint + ofs])) {
+                lastOfs = ofs;
+                ofs = 2 * ofs + 1;
+            }
+            ofs = std::min(ofs, maxOfs);
+            lastOfs += hint;
+            ofs += hint;
+        }
+        // b[lastOfs] <= x < b[ofs]: binary search the gap
+        lastOfs++;
+        while (lastOfs < ofs) {
+            std::ptrdiff_t m = lastOfs + (ofs - lastOfs) / 2;
+            if (less(x, b[m])) ofs = m;
+            else lastOfs = m + 1;
+        }
+        return ofs;
+    }
+
+    /// Keeps run lengths decreasing fast enough that merges stay balanced.
+    void mergeCollapse() {
+        while (runs.size() > 1) {
+            std::size_t n = runs.size() - 2;
+            if ((n > 0 && runs[n - 1].len <= runs[n].len + runs[n + 1].len) ||
+                (n > 1 && runs[n - 2].len <= runs[n - 1].len + runs[n].len)) {
+                if (runs[n - 1].len < runs[n + 1].len) n--;
+            } else if (runs[n].len > runs[n + 1].len) {
+                break;
+            }
+            mergeAt(n);
+        }
+    }
+
+    /// Merges runs i and i + 1 of the stack.
+    void mergeAt(std::size_t i) {
+        std::ptrdiff_t base1 = runs[i].base, len1 = runs[i].len;
+        std::ptrdiff_t base2 = runs[i + 1].base, len2 = runs[i + 1].len;
+        runs[i].len = len1 + len2;
+        runs.erase(runs.begin() + i + 1);
+        if (stats) stats->merges++;
+
+        // Left-run prefix not greater than the right run's first element is in place
+        std::ptrdiff_t k = gallopRight(a[base2], a + base1, len1, 0);
+        base1 += k;
+        len1 -= k;
+        if (len1 == 0) return;
+        // Right-run suffix not less than the left run's last element is in place
+        len2 = gallopLeft(a[base1 + len1 - 1], a + base2, len2, len2 - 1);
+        if (len2 == 0) return;
+
+        if (len1 <= len2) mergeLo(base1, len1, base2, len2);
+        else mergeHi(base1, len1, base2, len2);
+    }
+
+    void reserveTmp(std::ptrdiff_t n) {
+        if ((std::ptrdiff_t)tmp.size() < n) {
+            if ((std::ptrdiff_t)tmp.capacity() < n) p.allocate();
+            tmp.resize(n);
+        }
+    }
+
+    void enteredGallop() {
+        if (stats) stats->gallops++;
+    }
+
+    /// Merge left to right with the (shorter) left run in tmp.
+    void mergeLo(std::ptrdiff_t base1, std::ptrdiff_t len1, std::ptrdiff_t base2, std::ptrdiff_t len2) {
+        reserveTmp(len1);
+        std::move(a + base1, a + base1 + len1, tmp.begin());
+        p.assign(len1);
+        T* t = tmp.data();
+        std::ptrdiff_t c1 = 0, c2 = base2, dest = base1;
+
+        // a[base2] is smaller than every left-run element left after the gallop
+        a[dest++] = std::move(a[c2++]);
+        p.assign();
+        if (--len2 == 0) {
+            std::move(t + c1, t + c1 + len1, a + dest);
+            p.assign(len1);
+            return;
+        }
+        if (len1 == 1) {
+            std::move(a + c2, a + c2 + len2, a + dest);
+            a[dest + len2] = std::move(t[c1]);
+            p.assign(len2 + 1);
+            return;
+        }
+
+        while (true) {
+            std::ptrdiff_t count1 = 0, count2 = 0; // consecutive wins per side
+            do {
+                if (less(a[c2], t[c1])) {
+                    a[dest++] = std::move(a[c2++]);
+                    p.assign();
+                    count2++;
+                    count1 = 0;
+                    if (--len2 == 0) goto done;
+                } else {
+                    a[dest++] = std::move(t[c1++]);
+                    p.assign();
+                    count1++;
+                    count2 = 0;
+                    if (--len1 == 1) goto copyRight;
+                }
+            } while ((count1 | count2) < minGallop);
+
+            enteredGallop();
+            minGallop++;
+            do {
+                minGallop -= minGallop > 1;
+                count1 = gallopRight(a[c2], t + c1, len1, 0);
+                if (count1) {
+                    std::move(t + c1, t + c1 + count1, a + dest);
+                    p.assign(count1);
+                    dest += count1;
+                    c1 += count1;
+                    len1 -= count1;
+                    if (len1 == 1) goto copyRight;
+                    if (len1 == 0) goto done;
+                }
+                a[dest++] = std::move(a[c2++]);
+                p.assign();
+                if (--len2 == 0) goto done;
+
+                count2 = gallopLeft(t[c1], a + c2, len2, 0);
+                if (count2) {
+                    std::move(a + c2, a + c2 + count2, a + dest);
+                    p.assign(count2);
+                    dest += count2;
+                    c2 += count2;
+                    len2 -= count2;
+                    if (len2 == 0) goto done;
+                }
+                a[dest++] = std::move(t[c1++]);
+                p.assign();
+                if (--len1 == 1) goto copyRight;
+            } while (count1 >= MIN_GALLOP || count2 >= MIN_GALLOP);
+            minGallop++; // leaving gallop mode costs a little
+        }
+
+    copyRight:
+        // One left element remains and it belongs after the rest of the right run
+        std::move(a + c2, a + c2 + len2, a + dest);
+        a[dest + len2] = std::move(t[c1]);
+        p.assign(len2 + 1);
+        return;
+    done:
+        std::move(t + c1, t + c1 + len1, a + dest);
+        p.assign(len1);
+    }
+
+    /// Merge right to left with the (shorter) right run in tmp.
+    void mergeHi(std::ptrdiff_t base1, std::ptrdiff_t len1, std::ptrdiff_t base2, std::ptrdiff_t len2) {
+        reserveTmp(len2);
+        std::move(a + base2, a + base2 + len2, tmp.begin());
+        p.assign(len2);
+        T* t = tmp.data();
+        std::ptrdiff_t c1 = base1 + len1 - 1, c2 = len2 - 1, dest = base2 + len2 - 1;
+
+        // a[c1] is larger than every right-run element left after the gallop
+        a[dest--] = std::move(a[c1--]);
+        p.assign();
+        if (--len1 == 0) {
+            std::move(t, t + len2, a + dest - len2 + 1);
+            p.assign(len2);
+            return;
+        }
+        if (len2 == 1) {
+            dest -= len1;
+            c1 -= len1;
+            std::move_backward(a + c1 + 1, a + c1 + 1 + len1, a + dest + 1 + len1);
+            a[dest] = std::move(t[c2]);
+            p.assign(len1 + 1);
+            return;
+        }
+
+        while (true) {
+            std::ptrdiff_t count1 = 0, count2 = 0;
+            do {
+                if (less(t[c2], a[c1])) {
+                    a[dest--] = std::move(a[c1--]);
+                    p.assign();
+                    count1++;
+                    count2 = 0;
+                    if (--len1 == 0) goto done;
+                } else {
+                    a[dest--] = std::move(t[c2--]);
+                    p.assign();
+                    count2++;
+                    count1 = 0;
+                    if (--len2 == 1) goto copyLeft;
+                }
+            } while ((count1 | count2) < minGallop);
+
+            enteredGallop();
+            minGallop++;
+            do {
+                minGallop -= minGallop > 1;
+                count1 = len1 - gallopRight(t[c2], a + base1, len1, len1 - 1);
+                if (count1) {
+                    dest -= count1;
+                    c1 -= count1;
+                    len1 -= count1;
+                    std::move_backward(a + c1 + 1, a + c1 + 1 + count1, a + dest + 1 + count1);
+                    p.assign(count1);
+                    if (len1 == 0) goto done;
+                }
+                a[dest--] = std::move(t[c2--]);
+                p.assign();
+                if (--len2 == 1) goto copyLeft;
+
+                count2 = len2 - gallopLeft(a[c1], t, len2, len2 - 1);
+                if (count2) {
+                    dest -= count2;
+                    c2 -= count2;
+                    len2 -= count2;
+                    std::move(t + c2 + 1, t + c2 + 1 + count2, a + dest + 1);
+                    p.assign(count2);
+                    if (len2 == 1) goto copyLeft;
+                    if (len2 == 0) goto done;
+                }
+                a[dest--] = std::move(a[c1--]);
+                p.assign();
+                if (--len1 == 0) goto done;
+            } while (count1 >= MIN_GALLOP || count2 >= MIN_GALLOP);
+            minGallop++;
+        }
+
+    copyLeft:
+        // One right element remains and it belongs before the rest of the left run
+        dest -= len1;
+        c1 -= len1;
+        std::move_backward(a + c1 + 1, a + c1 + 1 + len1, a + dest + 1 + len1);
+        a[dest] = std::move(t[c2]);
+        p.assign(len1 + 1);
+        return;
+    done:
+        std::move(t, t + len2, a + dest - len2 + 1);
+        p.assign(len2);
+    }
+};
+
+/**
+ * @brief Adaptive stable merge sort of the whole vector (TimSort).
+ * @param stats Optional run/merge/gallop report.
+ */
+template <class T, class K, class Policy = NoCount>
+void timSort(std::vector<T>& data, const K& key, const Policy& p = Policy(), TimSortStats* stats = nullptr) {
+    TimSorter<T, K, Policy>(data, key, p, stats).sort((std::ptrdiff_t)data.size());
+}
+
+} // namespace sorting
+
+#endif // DAA_TIMSORT_HPP